@@ -0,0 +1,510 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+// Inputs up to this size are insertion sorted without sampling
+#define INSERTION_THRESHOLD 32
+// Number of adjacent pairs and values inspected by the sampler
+#define SAMPLE_SIZE 256
+// Radix sort only pays off once its passes are amortized
+#define RADIX_THRESHOLD 4096
+// Run merge is picked when runs are at least this long on average
+#define MIN_AVERAGE_RUN 32
+// Three-way quick sort is picked when at most this fraction of the sample is
+// distinct, about ten values in a full sample; past that radix sort's fixed
+// passes are faster than one partition per distinct key
+#define MAX_DISTINCT_FRACTION 0.04
+
+enum class SortAlgorithm {
+    INSERTION,
+    COUNTING,
+    RADIX,
+    RUN_MERGE,
+    THREE_WAY,
+    INTROSORT
+};
+
+const char *algorithm_name(SortAlgorithm algorithm) {
+    switch (algorithm) {
+    case SortAlgorithm::INSERTION: return "insertion";
+    case SortAlgorithm::COUNTING: return "counting";
+    case SortAlgorithm::RADIX: return "radix";
+    case SortAlgorithm::RUN_MERGE: return "run_merge";
+    case SortAlgorithm::THREE_WAY: return "three_way";
+    default: return "introsort";
+    }
+}
+
+// What sort() measured and what it chose, passed to the stats hook
+struct SortStats {
+    int size;
+    int sample_size;            // Adjacent pairs and values inspected
+    double ascending_fraction;  // Sampled adjacent pairs already in order
+    double descending_fraction; // Sampled adjacent pairs strictly descending
+    int estimated_runs;         // Extrapolated from the sampled direction changes
+    int64_t sampled_range;      // max - min over the sampled values
+    double distinct_fraction;   // Distinct values in the sample
+    SortAlgorithm algorithm;
+};
+
+std::function<void(const SortStats &)> sort_stats_hook;
+
+// Install a callback that sees every decision made by sort(), pass nullptr to remove it
+void set_sort_stats_hook(std::function<void(const SortStats &)> hook) {
+    sort_stats_hook = std::move(hook);
+}
+
+void __swap(int *array, int a, int b) {
+    int tmp = array[a];
+    array[a] = array[b];
+    array[b] = tmp;
+}
+
+// Time complexity: O(N^2), O(N) for sorted input
+void __insertion_sort(int *array, int s_idx, int e_idx) {
+    for (int i = s_idx + 1; i < e_idx; i++) {
+        int insert_val = array[i];
+        int j = i;
+        while (j > s_idx && array[j - 1] > insert_val) {
+            array[j] = array[j - 1];
+            j--;
+        }
+        array[j] = insert_val;
+    }
+}
+
+// Time complexity: O(N + K) for K = max - min + 1
+// Space complexity: O(K)
+void __counting_sort(int *array, int size, int min_val, int max_val) {
+    std::vector<int> counts(static_cast<size_t>(static_cast<int64_t>(max_val) - min_val + 1), 0);
+    for (int i = 0; i < size; i++) {
+        counts[static_cast<int64_t>(array[i]) - min_val]++;
+    }
+    int out = 0;
+    for (size_t v = 0; v < counts.size(); v++) {
+        for (int c = counts[v]; c > 0; c--) {
+            array[out++] = static_cast<int>(min_val + static_cast<int64_t>(v));
+        }
+    }
+}
+
+// LSD radix sort with 8-bit digits, digits equal in every key are skipped
+// Time complexity: O(N)
+// Space complexity: O(N)
+void __radix_sort(int *array, int size) {
+    std::vector<uint32_t> buffer(size);
+    std::vector<uint32_t> keys(size);
+    uint32_t counts[4][256] = {};
+    for (int i = 0; i < size; i++) {
+        keys[i] = static_cast<uint32_t>(array[i]) ^ 0x80000000u; // Order negative keys first
+        for (int digit = 0; digit < 4; digit++) {
+            counts[digit][(keys[i] >> (8 * digit)) & 0xff]++;
+        }
+    }
+    uint32_t *src = keys.data(), *dst = buffer.data();
+    for (int digit = 0; digit < 4; digit++) {
+        int shift = 8 * digit;
+        if (counts[digit][(src[0] >> shift) & 0xff] == static_cast<uint32_t>(size))
+            continue;
+        uint32_t offsets[256];
+        uint32_t sum = 0;
+        for (int b = 0; b < 256; b++) {
+            offsets[b] = sum;
+            sum += counts[digit][b];
+        }
+        for (int i = 0; i < size; i++) {
+            dst[offsets[(src[i] >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    for (int i = 0; i < size; i++) {
+        array[i] = static_cast<int>(src[i] ^ 0x80000000u);
+    }
+}
+
+// Natural merge sort: existing ascending runs are kept, strictly descending
+// runs are reversed, short runs are extended with insertion sort, and runs
+// are merged pairwise until one is left
+// Time complexity: O(N log R) for R runs, O(N) for sorted or reversed input
+// Space complexity: O(N)
+void __run_merge_sort(int *array, int size) {
+    std::vector<int> run_starts;
+    int i = 0;
+    while (i < size) {
+        int start = i++;
+        if (i < size && array[i] < array[i - 1]) {
+            // Strictly descending, so reversing keeps equal keys in order
+            while (i < size && array[i] < array[i - 1]) i++;
+            std::reverse(array + start, array + i);
+        } else {
+            while (i < size && array[i] >= array[i - 1]) i++;
+        }
+        // Extend short runs so random stretches do not create tiny runs
+        if (i - start < INSERTION_THRESHOLD && i < size) {
+            i = std::min(start + INSERTION_THRESHOLD, size);
+            __insertion_sort(array, start, i);
+        }
+        run_starts.push_back(start);
+    }
+    run_starts.push_back(size);
+
+    std::vector<int> buffer(size);
+    while (run_starts.size() > 2) {
+        std::vector<int> merged_starts;
+        size_t r = 0;
+        for (; r + 2 < run_starts.size(); r += 2) {
+            int s_idx = run_starts[r], mid_idx = run_starts[r + 1], e_idx = run_starts[r + 2];
+            std::merge(array + s_idx, array + mid_idx, array + mid_idx, array + e_idx, buffer.data() + s_idx);
+            std::memcpy(array + s_idx, buffer.data() + s_idx, sizeof(int) * (e_idx - s_idx));
+            merged_starts.push_back(s_idx);
+        }
+        if (r + 1 < run_starts.size())
+            merged_starts.push_back(run_starts[r]); // Odd run out waits for the next round
+        merged_starts.push_back(size);
+        run_starts.swap(merged_starts);
+    }
+}
+
+void __sift_down(int *array, int s_idx, int root, int size) {
+    while (true) {
+        int largest = root;
+        int left = 2 * root + 1, right = 2 * root + 2;
+        if (left < size && array[s_idx + left] > array[s_idx + largest]) largest = left;
+        if (right < size && array[s_idx + right] > array[s_idx + largest]) largest = right;
+        if (largest == root) return;
+        __swap(array, s_idx + root, s_idx + largest);
+        root = largest;
+    }
+}
+
+void __heap_sort(int *array, int s_idx, int e_idx) {
+    int size = e_idx - s_idx;
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        __sift_down(array, s_idx, i, size);
+    }
+    for (int end = size - 1; end > 0; end--) {
+        __swap(array, s_idx, s_idx + end);
+        __sift_down(array, s_idx, 0, end);
+    }
+}
+
+// Quick sort with median-of-three pivots, heap sort once the depth budget
+// runs out and insertion sort for short ranges
+void __introsort(int *array, int s_idx, int e_idx, int depth_limit) {
+    while (e_idx - s_idx > INSERTION_THRESHOLD) {
+        if (depth_limit-- == 0) {
+            __heap_sort(array, s_idx, e_idx);
+            return;
+        }
+        int mid = s_idx + (e_idx - s_idx) / 2;
+        if (array[mid] < array[s_idx]) __swap(array, mid, s_idx);
+        if (array[e_idx - 1] < array[s_idx]) __swap(array, e_idx - 1, s_idx);
+        if (array[e_idx - 1] < array[mid]) __swap(array, e_idx - 1, mid);
+        int pivot = array[mid];
+
+        // Hoare partition
+        int left = s_idx, right = e_idx - 1;
+        while (left <= right) {
+            while (array[left] < pivot) left++;
+            while (array[right] > pivot) right--;
+            if (left <= right)
+                __swap(array, left++, right--);
+        }
+        // Recurse into the smaller side, loop on the larger one
+        if (right - s_idx < e_idx - left) {
+            __introsort(array, s_idx, right + 1, depth_limit);
+            s_idx = left;
+        } else {
+            __introsort(array, left, e_idx, depth_limit);
+            e_idx = right + 1;
+        }
+    }
+    __insertion_sort(array, s_idx, e_idx);
+}
+
+// Quick sort with a three-way partition, keys equal to the pivot are final
+// after one pass, so D distinct keys need about log D levels whatever their range
+// Heap sort takes over once the depth budget runs out
+// Time complexity: O(N log D) for D distinct keys, O(N log N) worst case
+void __three_way_quick_sort(int *array, int s_idx, int e_idx, int depth_limit) {
+    while (e_idx - s_idx > INSERTION_THRESHOLD) {
+        if (depth_limit-- == 0) {
+            __heap_sort(array, s_idx, e_idx);
+            return;
+        }
+        int mid = s_idx + (e_idx - s_idx) / 2;
+        int a = array[s_idx], b = array[mid], c = array[e_idx - 1];
+        int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        // [s_idx, lt) < pivot, [lt, i) == pivot, [gt, e_idx) > pivot
+        int lt = s_idx, i = s_idx, gt = e_idx;
+        while (i < gt) {
+            if (array[i] < pivot)
+                __swap(array, lt++, i++);
+            else if (array[i] > pivot)
+                __swap(array, i, --gt);
+            else
+                i++;
+        }
+        // Recurse into the smaller side, loop on the larger one
+        if (lt - s_idx < e_idx - gt) {
+            __three_way_quick_sort(array, s_idx, lt, depth_limit);
+            s_idx = gt;
+        } else {
+            __three_way_quick_sort(array, gt, e_idx, depth_limit);
+            e_idx = lt;
+        }
+    }
+    __insertion_sort(array, s_idx, e_idx);
+}
+
+// Sample the input and pick an algorithm
+// Time complexity: O(SAMPLE_SIZE log SAMPLE_SIZE)
+SortStats __sample(const int *array, int size) {
+    SortStats stats = {};
+    stats.size = size;
+    if (size <= INSERTION_THRESHOLD) {
+        stats.algorithm = SortAlgorithm::INSERTION;
+        return stats;
+    }
+
+    // Evenly spaced adjacent pairs give sortedness, their left values give range and duplicates
+    int sample_size = std::min(SAMPLE_SIZE, size - 1);
+    std::vector<int> values(sample_size);
+    int ascending = 0, descending = 0, direction_changes = 0;
+    bool last_ascending = true;
+    for (int k = 0; k < sample_size; k++) {
+        int i = static_cast<int>(static_cast<int64_t>(k) * (size - 1) / sample_size);
+        values[k] = array[i];
+        bool is_ascending = array[i] <= array[i + 1];
+        if (is_ascending)
+            ascending++;
+        else
+            descending++;
+        if (k > 0 && is_ascending != last_ascending)
+            direction_changes++;
+        last_ascending = is_ascending;
+    }
+    std::sort(values.begin(), values.end());
+    int distinct = static_cast<int>(std::unique(values.begin(), values.end()) - values.begin());
+
+    stats.sample_size = sample_size;
+    stats.ascending_fraction = static_cast<double>(ascending) / sample_size;
+    stats.descending_fraction = static_cast<double>(descending) / sample_size;
+    // Descending runs are reversed in one pass, so run boundaries show up as pairs
+    // against the majority direction, or as switches of direction when the
+    // minority pairs form long runs of their own (organ pipes); take the smaller
+    int boundaries = std::min(std::min(ascending, descending), direction_changes);
+    stats.estimated_runs = 1 + static_cast<int>(static_cast<int64_t>(boundaries) * (size - 1) / sample_size);
+    stats.sampled_range = static_cast<int64_t>(values[distinct - 1]) - values[0];
+    stats.distinct_fraction = static_cast<double>(distinct) / sample_size;
+
+    if (static_cast<int64_t>(stats.estimated_runs) * MIN_AVERAGE_RUN <= size)
+        stats.algorithm = SortAlgorithm::RUN_MERGE; // Few long runs
+    else if (stats.sampled_range <= 2 * static_cast<int64_t>(size))
+        stats.algorithm = SortAlgorithm::COUNTING; // Confirmed against the exact range before use
+    else if (stats.distinct_fraction <= MAX_DISTINCT_FRACTION)
+        stats.algorithm = SortAlgorithm::THREE_WAY; // Few unique keys spread over a wide range
+    else if (size >= RADIX_THRESHOLD)
+        stats.algorithm = SortAlgorithm::RADIX;
+    else
+        stats.algorithm = SortAlgorithm::INTROSORT;
+    return stats;
+}
+
+// Sort array in ascending order with the algorithm that best fits the input
+// Every decision is reported to the hook installed with set_sort_stats_hook()
+// Time complexity: O(N log N) worst case, O(N) for presorted, reversed, narrow-range or radix-friendly input,
+// O(N log D) for D distinct keys
+void sort(int *array, int size) {
+    if (size <= 1)
+        return;
+
+    SortStats stats = __sample(array, size);
+    if (stats.algorithm == SortAlgorithm::COUNTING) {
+        // The sample may have missed outliers, check the exact range first
+        auto bounds = std::minmax_element(array, array + size);
+        int64_t range = static_cast<int64_t>(*bounds.second) - *bounds.first;
+        if (range <= 4 * static_cast<int64_t>(size)) {
+            stats.sampled_range = range;
+            __counting_sort(array, size, *bounds.first, *bounds.second);
+        } else {
+            stats.algorithm = (size >= RADIX_THRESHOLD) ? SortAlgorithm::RADIX : SortAlgorithm::INTROSORT;
+        }
+    }
+
+    switch (stats.algorithm) {
+    case SortAlgorithm::INSERTION:
+        __insertion_sort(array, 0, size);
+        break;
+    case SortAlgorithm::RADIX:
+        __radix_sort(array, size);
+        break;
+    case SortAlgorithm::RUN_MERGE:
+        __run_merge_sort(array, size);
+        break;
+    case SortAlgorithm::THREE_WAY:
+    case SortAlgorithm::INTROSORT:
+    {
+        int depth_limit = 0;
+        for (int n = size; n > 1; n >>= 1) depth_limit += 2;
+        if (stats.algorithm == SortAlgorithm::THREE_WAY)
+            __three_way_quick_sort(array, 0, size, depth_limit);
+        else
+            __introsort(array, 0, size, depth_limit);
+        break;
+    }
+    default: // COUNTING already ran
+        break;
+    }
+
+    if (sort_stats_hook)
+        sort_stats_hook(stats);
+}
+
+// Helper function to print an array
+void print_array(const int *array, int size) {
+    for (int i = 0; i < size; i++) {
+        std::cout << array[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Function to verify the array is sorted and has no added or removed elements
+void verify_sort_and_elements(const std::vector<int>& original, const int *sorted_array, int size) {
+    // Check sorted order
+    for (int i = 1; i < size; i++) {
+        assert(sorted_array[i - 1] <= sorted_array[i]);
+    }
+
+    // Check that no elements are added or removed
+    std::vector<int> sorted_copy(sorted_array, sorted_array + size);
+    std::sort(sorted_copy.begin(), sorted_copy.end());
+
+    std::vector<int> original_copy = original;
+    std::sort(original_copy.begin(), original_copy.end());
+
+    assert(sorted_copy == original_copy);
+}
+
+const char *pattern_names[] = {"random", "sorted", "reversed", "nearly sorted", "few unique",
+                               "narrow range", "organ pipe", "random + outlier"};
+const int num_patterns = 8;
+
+void fill_pattern(std::vector<int> &test, int pattern) {
+    int size = static_cast<int>(test.size());
+    for (int i = 0; i < size; i++) {
+        switch (pattern) {
+        case 0: test[i] = std::rand() - RAND_MAX / 2; break;
+        case 1: test[i] = i; break;
+        case 2: test[i] = size - i; break;
+        case 3: test[i] = (std::rand() % 200 == 0) ? std::rand() : i; break;
+        case 4: test[i] = (std::rand() % 8) * 1000003; break;
+        case 5: test[i] = std::rand() % (size + 1) - size / 2; break;
+        case 6: test[i] = (i < size / 2) ? i : size - i; break;
+        default: test[i] = std::rand() % (size + 1); break;
+        }
+    }
+    if (pattern == 7 && size > 0)
+        test[size / 3] = INT32_MAX; // Outside the sampled range, must not break counting sort
+}
+
+void test_adaptive_sort() {
+    const int small_test_size = 10;
+    const int threshold_to_print = 20;
+
+    // Seed random number generator
+    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+
+    // Small random test
+    std::cout << "Small Random Test:\n";
+    std::vector<int> small_test(small_test_size);
+    for (int& num : small_test) {
+        num = std::rand() % 100; // Random numbers between 0 and 99
+    }
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "Before Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+    std::vector<int> small_test_copy = small_test;
+    sort(small_test.data(), small_test_size);
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "After Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+    verify_sort_and_elements(small_test_copy, small_test.data(), small_test_size);
+
+    // Every pattern at several sizes, and the expected choices for clear-cut inputs
+    std::cout << "\nPattern Test:\n";
+    SortStats last = {};
+    set_sort_stats_hook([&](const SortStats &stats) { last = stats; });
+    for (int size : {2, 33, 1000, 100000}) {
+        for (int pattern = 0; pattern < num_patterns; pattern++) {
+            std::vector<int> test(size);
+            fill_pattern(test, pattern);
+            std::vector<int> test_copy = test;
+            sort(test.data(), size);
+            verify_sort_and_elements(test_copy, test.data(), size);
+            assert(last.size == size);
+            if (size == 100000) {
+                if (pattern == 0) assert(last.algorithm == SortAlgorithm::RADIX);
+                if (pattern == 1 || pattern == 2 || pattern == 3 || pattern == 6)
+                    assert(last.algorithm == SortAlgorithm::RUN_MERGE);
+                if (pattern == 4) assert(last.algorithm == SortAlgorithm::THREE_WAY);
+                if (pattern == 5) assert(last.algorithm == SortAlgorithm::COUNTING);
+                if (pattern == 7) assert(last.algorithm != SortAlgorithm::COUNTING);
+            }
+        }
+    }
+    set_sort_stats_hook(nullptr);
+}
+
+void benchmark_adaptive_sort() {
+    const int bench_size = 1000000;
+    const int num_runs = 3;
+
+    std::cout << "\nBenchmark (" << bench_size << " elements):\n";
+    SortStats last = {};
+    set_sort_stats_hook([&](const SortStats &stats) { last = stats; });
+    std::vector<int> test(bench_size);
+    for (int pattern = 0; pattern < num_patterns; pattern++) {
+        double adaptive_time = 0.0, std_time = 0.0;
+        for (int run = 0; run < num_runs; run++) {
+            fill_pattern(test, pattern);
+            std::vector<int> test_copy = test;
+
+            auto start_time = std::chrono::high_resolution_clock::now();
+            sort(test.data(), bench_size);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed_time = end_time - start_time;
+            adaptive_time += elapsed_time.count();
+
+            start_time = std::chrono::high_resolution_clock::now();
+            std::sort(test_copy.begin(), test_copy.end());
+            end_time = std::chrono::high_resolution_clock::now();
+            elapsed_time = end_time - start_time;
+            std_time += elapsed_time.count();
+
+            assert(test == test_copy);
+        }
+        std::cout << pattern_names[pattern] << ": " << algorithm_name(last.algorithm) << " "
+                  << adaptive_time / num_runs << " seconds, std::sort " << std_time / num_runs
+                  << " seconds (ascending " << last.ascending_fraction << ", distinct "
+                  << last.distinct_fraction << ", estimated runs " << last.estimated_runs << ")\n";
+    }
+    set_sort_stats_hook(nullptr);
+}
+
+int main() {
+    test_adaptive_sort();
+    benchmark_adaptive_sort();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
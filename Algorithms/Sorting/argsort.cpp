@@ -0,0 +1,450 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+// apply_permutation() works on destination blocks of at most this many bytes,
+// about what stays resident in L2
+#define APPLY_BLOCK_BYTES (1 << 18)
+// Elements up to this many bytes (all columns together) are applied by blocks,
+// wider ones by prefetched cycle following
+#define APPLY_BLOCKED_MAX_BYTES 32
+// Cycle following prefetches the element this many steps ahead in the cycle
+#define APPLY_PREFETCH_DISTANCE 8
+
+// Map a signed key to an unsigned one with the same order
+inline uint32_t __order_preserving_key(int key) {
+    return static_cast<uint32_t>(key) ^ 0x80000000u;
+}
+
+// Sort packed (key << 32 | index) pairs by their upper 32 bits
+// LSD radix sort with 8-bit digits; it is stable, so equal keys keep their
+// index order and the lower half never needs a pass
+// Time complexity: O(N)
+// Space complexity: O(N)
+void __radix_sort_packed(uint64_t *pairs, int size) {
+    std::vector<uint64_t> buffer(size);
+    uint64_t *src = pairs;
+    uint64_t *dst = buffer.data();
+
+    // All four histograms in one pass over the data
+    uint32_t counts[4][256] = {};
+    for (int i = 0; i < size; i++) {
+        uint32_t key = static_cast<uint32_t>(pairs[i] >> 32);
+        for (int digit = 0; digit < 4; digit++) {
+            counts[digit][(key >> (8 * digit)) & 0xff]++;
+        }
+    }
+
+    for (int digit = 0; digit < 4; digit++) {
+        // Skip digits where every key falls into the same bucket
+        if (counts[digit][(static_cast<uint32_t>(src[0] >> 32) >> (8 * digit)) & 0xff] == static_cast<uint32_t>(size))
+            continue;
+        uint32_t offsets[256];
+        uint32_t sum = 0;
+        for (int b = 0; b < 256; b++) {
+            offsets[b] = sum;
+            sum += counts[digit][b];
+        }
+        int shift = 32 + 8 * digit;
+        for (int i = 0; i < size; i++) {
+            dst[offsets[(src[i] >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != pairs)
+        std::memcpy(pairs, src, sizeof(uint64_t) * size);
+}
+
+// Fill indices with the permutation that sorts records by key_of(record), an int
+// Keys are packed with their 32-bit index into 64-bit words and radix sorted,
+// so only 8 bytes per element move no matter how large the records are
+// Equal keys keep their order
+// Time complexity: O(N)
+template <typename Record, typename KeyOf>
+void argsort_records(const Record *records, int size, KeyOf key_of, uint32_t *indices) {
+    if (size <= 0)
+        return;
+
+    std::vector<uint64_t> pairs(size);
+    for (int i = 0; i < size; i++) {
+        pairs[i] = (static_cast<uint64_t>(__order_preserving_key(key_of(records[i]))) << 32) |
+                   static_cast<uint32_t>(i);
+    }
+    __radix_sort_packed(pairs.data(), size);
+    for (int i = 0; i < size; i++) {
+        indices[i] = static_cast<uint32_t>(pairs[i]);
+    }
+}
+
+// Fill indices with the permutation that sorts keys, equal keys keep their order
+// Time complexity: O(N)
+void argsort(const int *keys, int size, uint32_t *indices) {
+    argsort_records(keys, size, [](int key) { return key; }, indices);
+}
+
+template <typename T>
+inline void __shift_column(T *column, uint32_t dst, uint32_t src) {
+    column[dst] = std::move(column[src]);
+}
+
+// Prefetch every cache line of column[k] for writing
+template <typename T>
+inline void __prefetch_column(const T *column, uint32_t k) {
+    const char *first = reinterpret_cast<const char *>(column + k);
+    for (size_t offset = 0; offset < sizeof(T); offset += 64) {
+        __builtin_prefetch(first + offset, 1);
+    }
+}
+
+// Cycle-following apply, see apply_permutation()
+// Every move is a random access. A second cursor runs APPLY_PREFETCH_DISTANCE
+// steps ahead through perm, which is small and mostly cached, and prefetches the
+// records it reaches, so the misses on the records overlap instead of queueing
+// perm is used to mark visited slots and is restored before returning
+// Time complexity: O(N)
+// Space complexity: O(1)
+template <typename... Columns>
+void __apply_permutation_cycles(uint32_t *perm, int size, Columns *...columns) {
+    const uint32_t visited = 0x80000000u; // Indices fit in 31 bits
+    assert(size >= 0 && static_cast<uint32_t>(size) < visited);
+
+    for (uint32_t start = 0; start < static_cast<uint32_t>(size); start++) {
+        if (perm[start] & visited)
+            continue;
+        if (perm[start] == start) {
+            perm[start] |= visited;
+            continue;
+        }
+        // Hold the first element of the cycle, then pull every other element
+        // into the slot that wants it
+        std::tuple<Columns...> saved(std::move(columns[start])...);
+        uint32_t current = start;
+        uint32_t ahead = start;
+        for (int d = 0; d < APPLY_PREFETCH_DISTANCE && perm[ahead] != start; d++) {
+            ahead = perm[ahead];
+            (__prefetch_column(columns, ahead), ...);
+        }
+        while (true) {
+            if (perm[ahead] != start && !(perm[ahead] & visited)) {
+                ahead = perm[ahead];
+                (__prefetch_column(columns, ahead), ...);
+            }
+            uint32_t next = perm[current];
+            perm[current] |= visited;
+            if (next == start)
+                break;
+            (__shift_column(columns, current, next), ...);
+            current = next;
+        }
+        std::apply([&](auto &...values) { ((columns[current] = std::move(values)), ...); }, saved);
+    }
+    for (int i = 0; i < size; i++) {
+        perm[i] &= ~visited;
+    }
+}
+
+// Swap the carried element with slot k of every column
+template <typename... Columns>
+inline void __swap_carried(std::tuple<Columns...> &carried, uint32_t k, Columns *...columns) {
+    std::apply([&](auto &...values) { (std::swap(values, columns[k]), ...); }, carried);
+}
+
+// Blocked apply, see apply_permutation()
+// Two passes over cache-sized blocks of the destination:
+//   1. Every element is moved into its destination block with an in-place
+//      multi-way partition. The permutation fixes each block's share in advance,
+//      and each block is filled from the front, so writes form one sequential
+//      stream per block.
+//   2. Every block is finished by cycle following, which now stays inside one
+//      block that fits in cache.
+// Each element's destination travels with it as a 4-byte tag, the records are
+// never copied out; perm itself is only read
+// Every element is moved about twice, so this only pays off for narrow elements
+// Not in place: the tags are a separate N * 4 byte array, as large as the
+// columns themselves for 4-byte elements. They cannot live in perm, which has
+// to come back unchanged and is the only copy of where each element goes
+// Time complexity: O(N)
+// Space complexity: O(N), N 4-byte tags plus one 4-byte head per block
+template <typename... Columns>
+void __apply_permutation_blocked(const uint32_t *perm, int size, Columns *...columns) {
+    if (size <= 0)
+        return;
+    const size_t element_bytes = (sizeof(Columns) + ... + 0);
+    // Largest power of two number of elements that fits in a block
+    int shift = 0;
+    while ((static_cast<size_t>(2) << shift) * element_bytes <= APPLY_BLOCK_BYTES) shift++;
+
+    // dest[j] is where the element now at j has to go
+    std::vector<uint32_t> dest(size);
+    for (int i = 0; i < size; i++) {
+        dest[perm[i]] = static_cast<uint32_t>(i);
+    }
+
+    // Pass 1: partition by destination block, heads[b] is the first unfilled slot of block b
+    uint32_t num_blocks = static_cast<uint32_t>(((static_cast<size_t>(size) - 1) >> shift) + 1);
+    std::vector<uint32_t> heads(num_blocks);
+    for (uint32_t b = 0; b < num_blocks; b++) {
+        heads[b] = b << shift;
+    }
+    for (uint32_t b = 0; b < num_blocks; b++) {
+        uint32_t block_end = std::min(static_cast<uint32_t>(size), (b + 1) << shift);
+        while (heads[b] < block_end) {
+            uint32_t hole = heads[b];
+            if ((dest[hole] >> shift) == b) {
+                heads[b]++;
+                continue;
+            }
+            // Carry the misplaced element to its block, taking whatever was there,
+            // until an element for block b turns up to fill the hole
+            std::tuple<Columns...> carried(std::move(columns[hole])...);
+            uint32_t carried_dest = dest[hole];
+            while ((carried_dest >> shift) != b) {
+                uint32_t target = carried_dest >> shift;
+                uint32_t k = heads[target]++;
+                while ((dest[k] >> shift) == target) k = heads[target]++;
+                __swap_carried(carried, k, columns...);
+                std::swap(carried_dest, dest[k]);
+            }
+            std::apply([&](auto &...values) { ((columns[hole] = std::move(values)), ...); }, carried);
+            dest[hole] = carried_dest;
+            heads[b]++;
+        }
+    }
+
+    // Pass 2: inside each block, send every element to its slot
+    for (uint32_t j = 0; j < static_cast<uint32_t>(size); j++) {
+        if (dest[j] == j)
+            continue;
+        std::tuple<Columns...> carried(std::move(columns[j])...);
+        uint32_t carried_dest = dest[j];
+        while (carried_dest != j) {
+            uint32_t k = carried_dest;
+            __swap_carried(carried, k, columns...);
+            std::swap(carried_dest, dest[k]);
+        }
+        std::apply([&](auto &...values) { ((columns[j] = std::move(values)), ...); }, carried);
+        dest[j] = j;
+    }
+}
+
+// Reorder every column in place so that column[i] becomes the old column[perm[i]]
+// Pass one array of structs, or every array of a struct of arrays; all columns
+// are moved in the same walk, so perm is read once and each cycle is followed once
+//
+// Plain cycle following touches a random record on every move, a cache and TLB
+// miss each once the columns outgrow the cache. Narrow elements are applied by
+// cache-sized destination blocks instead, which turns the misses into sequential
+// streams at the cost of moving every element twice. For elements wider than
+// APPLY_BLOCKED_MAX_BYTES the second move costs more than the misses it saves
+// (see the benchmark), so those keep cycle following with the records prefetched
+// a few steps ahead
+// perm is left unchanged
+// Time complexity: O(N)
+// Space complexity: O(N) for narrow elements, which allocate N 4-byte tags, otherwise O(1)
+template <typename... Columns>
+void apply_permutation(uint32_t *perm, int size, Columns *...columns) {
+    const size_t element_bytes = (sizeof(Columns) + ... + 0);
+    if (element_bytes <= APPLY_BLOCKED_MAX_BYTES &&
+        static_cast<size_t>(size) * element_bytes > APPLY_BLOCK_BYTES)
+        __apply_permutation_blocked(perm, size, columns...);
+    else
+        __apply_permutation_cycles(perm, size, columns...);
+}
+
+// Fixed-size record used by the benchmark, the key sits in front of the payload
+template <int Size>
+struct Record {
+    int key;
+    char payload[Size - sizeof(int)];
+};
+
+// Helper function to print an array
+void print_array(const int *array, int size) {
+    for (int i = 0; i < size; i++) {
+        std::cout << array[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Function to verify that indices is the stable sorting permutation of keys
+void verify_argsort(const std::vector<int>& keys, const uint32_t *indices) {
+    std::vector<uint32_t> expected(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        expected[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) {
+        return keys[a] < keys[b];
+    });
+    assert(std::equal(expected.begin(), expected.end(), indices));
+}
+
+void test_argsort() {
+    const int small_test_size = 10;
+    const int large_test_size = 100000;
+    const int threshold_to_print = 20;
+
+    // Seed random number generator
+    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+
+    // Small random test
+    std::cout << "Small Random Test:\n";
+    std::vector<int> small_test(small_test_size);
+    for (int& num : small_test) {
+        num = std::rand() % 100 - 50; // Negative keys too
+    }
+    std::vector<uint32_t> small_indices(small_test_size);
+    argsort(small_test.data(), small_test_size, small_indices.data());
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "Keys:\n";
+        print_array(small_test.data(), small_test_size);
+        std::cout << "Sorted Keys:\n";
+        for (uint32_t idx : small_indices) {
+            std::cout << small_test[idx] << " ";
+        }
+        std::cout << std::endl;
+    }
+    verify_argsort(small_test, small_indices.data());
+    std::vector<int> small_sorted = small_test;
+    apply_permutation(small_indices.data(), small_test_size, small_sorted.data()); // Fits in cache
+    for (int i = 0; i < small_test_size; i++) {
+        assert(small_sorted[i] == small_test[small_indices[i]]);
+    }
+
+    // Large test with many duplicates and extreme keys
+    std::cout << "\nLarge Random Test:\n";
+    std::vector<int> large_test(large_test_size);
+    for (int& num : large_test) {
+        num = std::rand() % 1000 - 500;
+    }
+    large_test[0] = INT32_MIN;
+    large_test[1] = INT32_MAX;
+    std::vector<uint32_t> large_indices(large_test_size);
+    argsort(large_test.data(), large_test_size, large_indices.data());
+    verify_argsort(large_test, large_indices.data());
+
+    // Array of structs and struct of arrays
+    std::cout << "\nApply Permutation Test:\n";
+    std::vector<Record<64>> records(large_test_size);
+    std::vector<int> column_a(large_test_size);
+    std::vector<double> column_b(large_test_size);
+    for (int i = 0; i < large_test_size; i++) {
+        records[i].key = large_test[i];
+        std::memset(records[i].payload, i & 0x7f, sizeof(records[i].payload));
+        column_a[i] = large_test[i];
+        column_b[i] = i;
+    }
+    std::vector<uint32_t> perm(large_test_size);
+    argsort_records(records.data(), large_test_size,
+                    [](const Record<64> &record) { return record.key; }, perm.data());
+    assert(perm == large_indices);
+    std::vector<Record<64>> records_blocked = records;
+    apply_permutation(perm.data(), large_test_size, records.data()); // Cycle following
+    apply_permutation(perm.data(), large_test_size, column_a.data(), column_b.data()); // Blocked
+    __apply_permutation_blocked(perm.data(), large_test_size, records_blocked.data());
+    assert(perm == large_indices); // The permutation is restored
+    for (int i = 0; i < large_test_size; i++) {
+        assert(records[i].key == large_test[perm[i]]);
+        assert(records[i].payload[sizeof(records[i].payload) - 1] == static_cast<char>(perm[i] & 0x7f));
+        assert(records_blocked[i].key == records[i].key);
+        assert(std::memcmp(records_blocked[i].payload, records[i].payload, sizeof(records[i].payload)) == 0);
+        assert(column_a[i] == large_test[perm[i]]);
+        assert(column_b[i] == perm[i]);
+        assert(i == 0 || column_a[i - 1] <= column_a[i]);
+    }
+
+    // Both paths are safe to call on empty and single-element inputs directly
+    for (int size : {0, 1}) {
+        uint32_t identity[1] = {0};
+        int column[1] = {42};
+        __apply_permutation_blocked(identity, size, column);
+        __apply_permutation_cycles(identity, size, column);
+        assert(identity[0] == 0 && column[0] == 42);
+    }
+}
+
+// Sort records directly and through argsort + apply_permutation
+template <int Size>
+void benchmark_record_size(int size, int num_runs) {
+    std::vector<Record<Size>> records(size);
+    double direct_time = 0.0, indirect_time = 0.0, apply_time = 0.0, blocked_time = 0.0, cycles_time = 0.0;
+
+    for (int run = 0; run < num_runs; run++) {
+        for (Record<Size> &record : records) {
+            record.key = std::rand();
+        }
+        std::vector<Record<Size>> direct = records;
+        std::vector<Record<Size>> by_blocks = records;
+        std::vector<Record<Size>> by_cycles = records;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::stable_sort(direct.begin(), direct.end(), [](const Record<Size> &a, const Record<Size> &b) {
+            return a.key < b.key;
+        });
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed_time = end_time - start_time;
+        direct_time += elapsed_time.count();
+
+        start_time = std::chrono::high_resolution_clock::now();
+        std::vector<uint32_t> perm(size);
+        argsort_records(records.data(), size, [](const Record<Size> &record) { return record.key; }, perm.data());
+        auto apply_start_time = std::chrono::high_resolution_clock::now();
+        apply_permutation(perm.data(), size, records.data());
+        end_time = std::chrono::high_resolution_clock::now();
+        elapsed_time = end_time - start_time;
+        indirect_time += elapsed_time.count();
+        elapsed_time = end_time - apply_start_time;
+        apply_time += elapsed_time.count();
+
+        // The same permutation applied by each strategy
+        start_time = std::chrono::high_resolution_clock::now();
+        __apply_permutation_blocked(perm.data(), size, by_blocks.data());
+        end_time = std::chrono::high_resolution_clock::now();
+        elapsed_time = end_time - start_time;
+        blocked_time += elapsed_time.count();
+
+        start_time = std::chrono::high_resolution_clock::now();
+        __apply_permutation_cycles(perm.data(), size, by_cycles.data());
+        end_time = std::chrono::high_resolution_clock::now();
+        elapsed_time = end_time - start_time;
+        cycles_time += elapsed_time.count();
+
+        for (int i = 0; i < size; i++) {
+            assert(records[i].key == direct[i].key);
+            assert(by_blocks[i].key == direct[i].key);
+            assert(by_cycles[i].key == direct[i].key);
+        }
+    }
+
+    std::cout << Size << "-byte records: std::stable_sort " << direct_time / num_runs
+              << " seconds, argsort + apply_permutation " << indirect_time / num_runs
+              << " seconds (apply " << apply_time / num_runs << " seconds; blocked "
+              << blocked_time / num_runs << " seconds, cycle following " << cycles_time / num_runs
+              << " seconds)\n";
+}
+
+void benchmark_argsort() {
+    const int bench_size = 1000000;
+    const int num_runs = 5;
+
+    std::cout << "\nRecord Size Benchmark (" << bench_size << " records):\n";
+    benchmark_record_size<16>(bench_size, num_runs);
+    benchmark_record_size<32>(bench_size, num_runs);
+    benchmark_record_size<64>(bench_size, num_runs);
+    benchmark_record_size<128>(bench_size, num_runs);
+    benchmark_record_size<256>(bench_size, num_runs);
+}
+
+int main() {
+    test_argsort();
+    benchmark_argsort();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
@@ -0,0 +1,529 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <cstdint>
+#include <utility>
+
+// Runs of this length are insertion sorted before merging starts
+#define RUN_SIZE 16
+
+// Reverse array[s_idx...e_idx)
+template <typename T>
+void __reverse(T *array, int s_idx, int e_idx) {
+    while (s_idx < --e_idx) {
+        std::swap(array[s_idx++], array[e_idx]);
+    }
+}
+
+// Swap the adjacent blocks array[s_idx...mid_idx) and array[mid_idx...e_idx) in place
+// Time complexity: O(N)
+template <typename T>
+void __rotate(T *array, int s_idx, int mid_idx, int e_idx) {
+    __reverse(array, s_idx, mid_idx);
+    __reverse(array, mid_idx, e_idx);
+    __reverse(array, s_idx, e_idx);
+}
+
+// Swap array[a_idx...a_idx + len) with array[b_idx...b_idx + len), front to back
+// With a_idx < b_idx the ranges may overlap, which moves the second range
+// left by b_idx - a_idx and whatever was in front of it to its end
+template <typename T>
+void __swap_ranges(T *array, int a_idx, int b_idx, int len) {
+    for (int i = 0; i < len; i++) {
+        std::swap(array[a_idx + i], array[b_idx + i]);
+    }
+}
+
+// First index in array[s_idx...e_idx) whose element is not less than value
+template <typename T, typename Less>
+int __lower_bound(const T *array, int s_idx, int e_idx, const T &value, Less less) {
+    while (s_idx < e_idx) {
+        int mid = s_idx + (e_idx - s_idx) / 2;
+        if (less(array[mid], value))
+            s_idx = mid + 1;
+        else
+            e_idx = mid;
+    }
+    return s_idx;
+}
+
+// First index in array[s_idx...e_idx) whose element is greater than value
+template <typename T, typename Less>
+int __upper_bound(const T *array, int s_idx, int e_idx, const T &value, Less less) {
+    while (s_idx < e_idx) {
+        int mid = s_idx + (e_idx - s_idx) / 2;
+        if (less(value, array[mid]))
+            e_idx = mid;
+        else
+            s_idx = mid + 1;
+    }
+    return s_idx;
+}
+
+template <typename T, typename Less>
+void __insertion_sort(T *array, int s_idx, int e_idx, Less less) {
+    for (int i = s_idx + 1; i < e_idx; i++) {
+        T insert_val = std::move(array[i]);
+        int j = i;
+        while (j > s_idx && less(insert_val, array[j - 1])) {
+            array[j] = std::move(array[j - 1]);
+            j--;
+        }
+        array[j] = std::move(insert_val);
+    }
+}
+
+// Stable merge of the sorted runs array[s_idx...mid_idx) and array[mid_idx...e_idx)
+// without any buffer: cut the longer run in half, binary search the cut in
+// the other run and rotate the middle blocks into place, giving two
+// independent merges. The smaller one is merged recursively and the larger
+// one in the loop, so the recursion depth is O(log N)
+// Time complexity: O(N log N) moves
+template <typename T, typename Less>
+void __merge_without_buffer(T *array, int s_idx, int mid_idx, int e_idx, Less less) {
+    while (s_idx < mid_idx && mid_idx < e_idx) {
+        // Already in order, typical for presorted input
+        if (!less(array[mid_idx], array[mid_idx - 1]))
+            return;
+        // Every right element goes first
+        if (less(array[e_idx - 1], array[s_idx])) {
+            __rotate(array, s_idx, mid_idx, e_idx);
+            return;
+        }
+
+        int left_cut, right_cut;
+        if (mid_idx - s_idx >= e_idx - mid_idx) {
+            // Right elements strictly less than the left pivot move in front of it
+            left_cut = s_idx + (mid_idx - s_idx) / 2;
+            right_cut = __lower_bound(array, mid_idx, e_idx, array[left_cut], less);
+        } else {
+            // Left elements not greater than the right pivot stay in front of it
+            right_cut = mid_idx + (e_idx - mid_idx) / 2;
+            left_cut = __upper_bound(array, s_idx, mid_idx, array[right_cut], less);
+        }
+        __rotate(array, left_cut, mid_idx, right_cut);
+        int new_mid = left_cut + (right_cut - mid_idx);
+
+        // [s_idx, left_cut) + [left_cut, new_mid) and [new_mid, new_mid + mid_idx - left_cut) + [.., e_idx)
+        int second_mid = new_mid + (mid_idx - left_cut);
+        if (new_mid - s_idx < e_idx - new_mid) {
+            __merge_without_buffer(array, s_idx, left_cut, new_mid, less);
+            s_idx = new_mid;
+            mid_idx = second_mid;
+        } else {
+            __merge_without_buffer(array, new_mid, second_mid, e_idx, less);
+            mid_idx = left_cut;
+            e_idx = new_mid;
+        }
+    }
+}
+
+// Move the first occurrence of up to wanted distinct values to the front of
+// array, in sorted order, and return how many were found
+// The found keys are rolled along the array as one block, so every other
+// element keeps its relative order and the sort stays stable
+// Time complexity: O(N log K + K^2) for K keys
+template <typename T, typename Less>
+int __collect_keys(T *array, int size, int wanted, Less less) {
+    int keys_idx = 0, num_keys = 1; // The keys are array[keys_idx...keys_idx + num_keys)
+    for (int i = 1; i < size && num_keys < wanted; i++) {
+        int pos = __lower_bound(array, keys_idx, keys_idx + num_keys, array[i], less);
+        if (pos < keys_idx + num_keys && !less(array[i], array[pos]))
+            continue; // Same value as a key
+        // Roll the keys up against array[i], then insert it among them
+        int gap = i - (keys_idx + num_keys);
+        __rotate(array, keys_idx, keys_idx + num_keys, i);
+        keys_idx += gap;
+        __rotate(array, pos + gap, i, i + 1);
+        num_keys++;
+    }
+    __rotate(array, 0, keys_idx, keys_idx + num_keys);
+    return num_keys;
+}
+
+// Merge array[s_idx...mid_idx) and array[mid_idx...e_idx) with the internal buffer
+// array[buf_idx...), which is outside both runs and at least e_idx - mid_idx long
+// The right run is swapped into the buffer and merged back from the end, so
+// the buffer only gets its elements back in another order
+// Time complexity: O(N)
+template <typename T, typename Less>
+void __merge_with_buffer(T *array, int s_idx, int mid_idx, int e_idx, int buf_idx, Less less) {
+    if (!less(array[mid_idx], array[mid_idx - 1]))
+        return;
+    int right_len = e_idx - mid_idx;
+    __swap_ranges(array, buf_idx, mid_idx, right_len);
+    int left = mid_idx, right = buf_idx + right_len, out = e_idx;
+    while (left > s_idx && right > buf_idx) {
+        // Ties take the right element first from the back, which keeps the merge stable
+        if (less(array[right - 1], array[left - 1]))
+            std::swap(array[--out], array[--left]);
+        else
+            std::swap(array[--out], array[--right]);
+    }
+    while (right > buf_idx) {
+        std::swap(array[--out], array[--right]);
+    }
+}
+
+// Block merge of the sorted runs array[s_idx...s_idx + left_len) and the
+// right_len elements after it, where left_len is a multiple of block and the
+// block elements in front of s_idx are the internal buffer
+// 1. The full blocks of both runs are selection sorted by their first element.
+//    Each block carries a key from array[keys_idx...); the keys are distinct
+//    and sorted, so they break ties between blocks and still tell which run a
+//    block came from once the blocks are shuffled.
+// 2. The blocks are merged front to back. The pending elements of one run
+//    are merged with the next block when it comes from the other run and are
+//    final when it comes from the same run. The buffer always sits right in
+//    front of the pending elements and output is written into it, so it
+//    travels through the merge.
+// 3. The last partial block of the right run is merged in from the back.
+// The merged runs end up block elements further left, followed by the buffer
+// Time complexity: O(N + (N / block)^2)
+template <typename T, typename Less>
+void __merge_blocks(T *array, int keys_idx, int s_idx, int left_len, int right_len, int block, Less less) {
+    int left_blocks = left_len / block;
+    int num_blocks = left_blocks + right_len / block;
+    int tail_len = right_len % block;
+
+    // The smallest right key, its position is tracked through the block swaps
+    int mid_key = keys_idx + left_blocks;
+    for (int u = 0; u + 1 < num_blocks; u++) {
+        int min_block = u;
+        for (int v = u + 1; v < num_blocks; v++) {
+            const T &first = array[s_idx + v * block];
+            const T &min_first = array[s_idx + min_block * block];
+            if (less(first, min_first) ||
+                (!less(min_first, first) && less(array[keys_idx + v], array[keys_idx + min_block])))
+                min_block = v;
+        }
+        if (min_block != u) {
+            __swap_ranges(array, s_idx + u * block, s_idx + min_block * block, block);
+            std::swap(array[keys_idx + u], array[keys_idx + min_block]);
+            if (mid_key == keys_idx + u)
+                mid_key = keys_idx + min_block;
+            else if (mid_key == keys_idx + min_block)
+                mid_key = keys_idx + u;
+        }
+    }
+    auto from_left = [&](int b) {
+        return left_blocks == num_blocks || less(array[keys_idx + b], array[mid_key]);
+    };
+
+    // [s_idx - block, out) is final, then comes the buffer, then the pending
+    // elements up to the next unmerged block
+    int out = s_idx - block;
+    bool pending_left = from_left(0);
+    for (int b = 1; b < num_blocks; b++) {
+        int next = s_idx + b * block;
+        bool next_left = from_left(b);
+        if (next_left == pending_left) {
+            __swap_ranges(array, out, out + block, next - out - block);
+            out = next - block;
+            continue;
+        }
+        int pending = out + block, right = next;
+        while (pending < next && right < next + block) {
+            // Ties take the element from the left run
+            if (less(array[right], array[pending]) || (next_left && !less(array[pending], array[right])))
+                std::swap(array[out++], array[right++]);
+            else
+                std::swap(array[out++], array[pending++]);
+        }
+        if (pending < next) {
+            // The block ran out first, move the rest of the pending elements behind the buffer
+            for (int i = next - 1; i >= pending; i--) {
+                std::swap(array[i], array[i + block]);
+            }
+        } else {
+            pending_left = next_left;
+        }
+    }
+    int blocks_end = s_idx + num_blocks * block;
+    __swap_ranges(array, out, out + block, blocks_end - out - block);
+    out = blocks_end - block;
+
+    // [s_idx - block, out) + buffer + tail: merge backwards into the front of the buffer
+    int left = out, right = blocks_end + tail_len, dst = out + tail_len;
+    while (left > s_idx - block && right > blocks_end) {
+        if (less(array[right - 1], array[left - 1]))
+            std::swap(array[--dst], array[--left]);
+        else
+            std::swap(array[--dst], array[--right]);
+    }
+    while (right > blocks_end) {
+        std::swap(array[--dst], array[--right]);
+    }
+
+    // Put the keys back in order for the next merge
+    __insertion_sort(array, keys_idx, keys_idx + num_blocks, less);
+}
+
+// Stable in-place merge sort in the style of GrailSort
+// The array is rearranged into [keys][buffer][data] by collecting about
+// 2 sqrt(N) distinct values, as a block of sqrt(N) buffer elements and enough
+// keys to tag every block of a merge:
+// 1. The data is insertion sorted in runs of RUN_SIZE, which are merged with
+//    the buffer as scratch space until they are a block long.
+// 2. Longer runs are merged with __merge_blocks(). Every pass moves the buffer
+//    from the front of the data to its end, and it is shifted back after.
+// 3. Keys and buffer are sorted and merged back into the data without a buffer.
+// Inputs with too few distinct values are sorted with plain rotation merges
+// Time complexity: O(N log N), O(N log^2 N) moves with few distinct values
+// Space complexity: O(1) heap and O(log N) stack
+template <typename T, typename Less>
+void block_merge_sort(T *array, int size, Less less) {
+    if (size <= RUN_SIZE) {
+        __insertion_sort(array, 0, size, less);
+        return;
+    }
+
+    // Smallest power of two block with block * block >= size
+    int block = RUN_SIZE;
+    while (static_cast<int64_t>(block) * block < size) block *= 2;
+    int num_keys = (size - 1) / block + 1;
+    int found = __collect_keys(array, size, num_keys + block, less);
+
+    if (found < num_keys + block) {
+        for (int s_idx = 0; s_idx < size; s_idx += RUN_SIZE) {
+            __insertion_sort(array, s_idx, std::min(s_idx + RUN_SIZE, size), less);
+        }
+        for (int64_t width = RUN_SIZE; width < size; width *= 2) {
+            for (int64_t s_idx = 0; s_idx + width < size; s_idx += 2 * width) {
+                int e_idx = static_cast<int>(std::min<int64_t>(s_idx + 2 * width, size));
+                __merge_without_buffer(array, static_cast<int>(s_idx), static_cast<int>(s_idx + width), e_idx, less);
+            }
+        }
+        return;
+    }
+
+    int buf_idx = num_keys;
+    int data_idx = found;
+    int64_t data_len = size - data_idx;
+    for (int s_idx = data_idx; s_idx < size; s_idx += RUN_SIZE) {
+        __insertion_sort(array, s_idx, std::min(s_idx + RUN_SIZE, size), less);
+    }
+    int64_t width = RUN_SIZE;
+    for (; width < block && width < data_len; width *= 2) {
+        for (int64_t s_idx = data_idx; s_idx + width < size; s_idx += 2 * width) {
+            int e_idx = static_cast<int>(std::min<int64_t>(s_idx + 2 * width, size));
+            __merge_with_buffer(array, static_cast<int>(s_idx), static_cast<int>(s_idx + width), e_idx, buf_idx, less);
+        }
+    }
+    for (; width < data_len; width *= 2) {
+        for (int64_t s_idx = data_idx; s_idx < size; s_idx += 2 * width) {
+            int left_len = static_cast<int>(std::min<int64_t>(width, size - s_idx));
+            int right_len = static_cast<int>(std::min<int64_t>(width, size - s_idx - left_len));
+            if (right_len == 0)
+                __swap_ranges(array, static_cast<int>(s_idx) - block, static_cast<int>(s_idx), left_len);
+            else
+                __merge_blocks(array, 0, static_cast<int>(s_idx), left_len, right_len, block, less);
+        }
+        // The buffer ended up behind the data, shift the data back over it
+        for (int i = size - block - 1; i >= buf_idx; i--) {
+            std::swap(array[i], array[i + block]);
+        }
+    }
+
+    __insertion_sort(array, 0, data_idx, less);
+    __merge_without_buffer(array, 0, data_idx, size, less);
+}
+
+void block_merge_sort(int *array, int size) {
+    block_merge_sort(array, size, [](int a, int b) { return a < b; });
+}
+
+// Buffered merge sort as in merge_sort.cpp, with an N-sized scratch buffer
+// Used as the baseline in the benchmark
+void __merge(int *array, int *sorted, int s_idx, int mid_idx, int e_idx)
+{
+    int left = s_idx;
+    int right = mid_idx + 1;
+    int len = 0;
+    while (left <= mid_idx && right <= e_idx) {
+        if (array[left] < array[right]) {
+            sorted[len++] = array[left++];
+        } else {
+            sorted[len++] = array[right++];
+        }
+    }
+
+    while (left <= mid_idx) {
+        sorted[len++] = array[left++];
+    }
+
+    while (right <= e_idx) {
+        sorted[len++] = array[right++];
+    }
+
+    for (int i = s_idx; i <= e_idx; i++) {
+        array[i] = sorted[i - s_idx];
+    }
+}
+
+void __merge_sort(int *array, int *sorted, int s_idx, int e_idx)
+{
+    int mid_idx;
+    if (s_idx >= e_idx)
+        return;
+    mid_idx = (s_idx + e_idx) / 2;
+    __merge_sort(array, sorted, s_idx, mid_idx);
+    __merge_sort(array, sorted, mid_idx + 1, e_idx);
+    __merge(array, sorted, s_idx, mid_idx, e_idx);
+}
+
+void buffered_merge_sort(int *array, int size) {
+    std::vector<int> sorted(size);
+    __merge_sort(array, sorted.data(), 0, size - 1);
+}
+
+// Record with a sort key and its original position, not default constructible
+struct Keyed {
+    int key;
+    int order;
+    Keyed(int key, int order) : key(key), order(order) {}
+};
+
+// Helper function to print an array
+void print_array(const int *array, int size) {
+    for (int i = 0; i < size; i++) {
+        std::cout << array[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Function to verify the array is sorted and has no added or removed elements
+void verify_sort_and_elements(const std::vector<int>& original, const int *sorted_array, int size) {
+    // Check sorted order
+    for (int i = 1; i < size; i++) {
+        assert(sorted_array[i - 1] <= sorted_array[i]);
+    }
+
+    // Check that no elements are added or removed
+    std::vector<int> sorted_copy(sorted_array, sorted_array + size);
+    std::sort(sorted_copy.begin(), sorted_copy.end());
+
+    std::vector<int> original_copy = original;
+    std::sort(original_copy.begin(), original_copy.end());
+
+    assert(sorted_copy == original_copy);
+}
+
+void test_block_merge_sort() {
+    const int small_test_size = 10;
+    const int large_test_size = 100000;
+    const int threshold_to_print = 20;
+
+    // Seed random number generator
+    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+
+    // Small random test
+    std::cout << "Small Random Test:\n";
+    std::vector<int> small_test(small_test_size);
+    for (int& num : small_test) {
+        num = std::rand() % 100; // Random numbers between 0 and 99
+    }
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "Before Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+
+    std::vector<int> small_test_copy = small_test;
+    block_merge_sort(small_test.data(), small_test_size);
+
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "After Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+
+    verify_sort_and_elements(small_test_copy, small_test.data(), small_test_size);
+
+    // Input patterns at sizes around the run and block boundaries; few unique
+    // keys take the path without an internal buffer
+    std::cout << "\nPattern Test:\n";
+    for (int size : {0, 1, 15, 16, 17, 256, 257, 511, 513, 5000, 65537, large_test_size}) {
+        for (int pattern = 0; pattern < 6; pattern++) {
+            std::vector<int> test(size);
+            for (int i = 0; i < size; i++) {
+                switch (pattern) {
+                case 0: test[i] = std::rand(); break;
+                case 1: test[i] = i; break;
+                case 2: test[i] = size - i; break;
+                case 3: test[i] = std::rand() % 4; break;
+                case 4: test[i] = std::rand() % 1000; break; // Just enough distinct keys at the largest size
+                default: test[i] = (i < size / 2) ? i + size : i; break; // two sorted runs, swapped
+                }
+            }
+            std::vector<int> test_copy = test;
+            block_merge_sort(test.data(), size);
+            verify_sort_and_elements(test_copy, test.data(), size);
+        }
+    }
+
+    // Stability: equal keys keep their original order, with and without the
+    // internal buffer; Keyed has no default constructor, elements are only swapped
+    std::cout << "\nStability Test:\n";
+    for (int distinct : {100, 5000}) {
+        std::vector<Keyed> records;
+        records.reserve(large_test_size);
+        for (int i = 0; i < large_test_size; i++) {
+            records.emplace_back(std::rand() % distinct, i);
+        }
+        block_merge_sort(records.data(), large_test_size,
+                         [](const Keyed &a, const Keyed &b) { return a.key < b.key; });
+        for (int i = 1; i < large_test_size; i++) {
+            assert(records[i - 1].key < records[i].key ||
+                   (records[i - 1].key == records[i].key && records[i - 1].order < records[i].order));
+        }
+    }
+}
+
+void benchmark_block_merge_sort() {
+    const int bench_size = 1000000;
+    const int num_runs = 5;
+    const char *names[] = {"random", "few unique", "nearly sorted"};
+
+    std::cout << "\nBenchmark (" << bench_size << " elements):\n";
+    std::vector<int> test(bench_size);
+    for (int pattern = 0; pattern < 3; pattern++) {
+        double block_time = 0.0, buffered_time = 0.0;
+        for (int run = 0; run < num_runs; run++) {
+            for (int i = 0; i < bench_size; i++) {
+                if (pattern == 0)
+                    test[i] = std::rand();
+                else if (pattern == 1)
+                    test[i] = std::rand() % 16;
+                else
+                    test[i] = (std::rand() % 100 == 0) ? std::rand() : i;
+            }
+            std::vector<int> test_copy = test;
+
+            auto start_time = std::chrono::high_resolution_clock::now();
+            block_merge_sort(test.data(), bench_size);
+            auto end_time = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> elapsed_time = end_time - start_time;
+            block_time += elapsed_time.count();
+
+            start_time = std::chrono::high_resolution_clock::now();
+            buffered_merge_sort(test_copy.data(), bench_size);
+            end_time = std::chrono::high_resolution_clock::now();
+            elapsed_time = end_time - start_time;
+            buffered_time += elapsed_time.count();
+
+            assert(test == test_copy);
+        }
+        std::cout << names[pattern] << ": block_merge_sort " << block_time / num_runs
+                  << " seconds, buffered merge sort " << buffered_time / num_runs << " seconds\n";
+    }
+}
+
+int main() {
+    test_block_merge_sort();
+    benchmark_block_merge_sort();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
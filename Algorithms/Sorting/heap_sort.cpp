@@ -59,6 +59,9 @@ int remove_max(int *array, int size)
 
 // Time complexity: O(N log N)
 void heap_sort(int *array, int size) {
+    if (size <= 0)
+        return;
+
     // O(N log N)
     build_max_heap(array, size);
     // O(N log N)
@@ -70,6 +73,73 @@ void heap_sort(int *array, int size) {
     }
 }
 
+// Rearrange array so that array[0...k-1] holds its k smallest elements in
+// ascending order, the order of the rest is unspecified
+// A max heap of the k smallest seen so far is kept in the front of the array
+// Time complexity: O(N log k)
+// Space complexity: O(1)
+void partial_sort(int *array, int size, int k) {
+    if (k > size)
+        k = size;
+    if (k <= 0)
+        return;
+
+    build_max_heap(array, k);
+    for (int i = k; i < size; i++) {
+        if (array[i] < array[0]) {
+            int tmp = array[i];
+            array[i] = array[0];
+            array[0] = tmp;
+            heapify(array, 0, k);
+        }
+    }
+    heap_sort(array, k);
+}
+
+// Streaming accumulator of the k smallest values pushed so far
+// Values are kept in a bounded max heap, so the largest of them is replaced
+// whenever a smaller one arrives
+class TopK {
+private:
+    std::vector<int> heap;
+    int k;
+
+public:
+    explicit TopK(int k) : k(k) {
+        heap.reserve(k > 0 ? k : 0);
+    }
+
+    // Time complexity: O(log k), O(k) once when the heap first fills up
+    void push(int value) {
+        if (static_cast<int>(heap.size()) < k) {
+            heap.push_back(value);
+            if (static_cast<int>(heap.size()) == k)
+                build_max_heap(heap.data(), k);
+        } else if (k > 0 && value < heap[0]) {
+            heap[0] = value;
+            heapify(heap.data(), 0, k);
+        }
+    }
+
+    int size() const {
+        return static_cast<int>(heap.size());
+    }
+
+    // Largest value still kept, only meaningful once size() == k
+    // Anything not smaller than this is rejected by push()
+    int threshold() const {
+        return heap.empty() ? 0 : heap[0];
+    }
+
+    // Returns the kept values in ascending order
+    // Time complexity: O(k log k)
+    std::vector<int> sorted() const {
+        std::vector<int> result = heap;
+        heap_sort(result.data(), static_cast<int>(result.size()));
+        return result;
+    }
+};
+
 // Helper function to print an array
 void print_array(const int *array, int size) {
     for (int i = 0; i < size; i++) {
@@ -157,8 +227,82 @@ void test_heap_sort() {
               << average_time << " seconds\n";
 }
 
+void test_partial_sort_and_top_k() {
+    const int large_test_size = 1000000;
+    const int k = 100;
+    const int num_runs = 10;
+
+    std::cout << "\nPartial Sort / Top-k Test:\n";
+    for (int size : {0, 1, 10, 1000}) {
+        for (int test_k : {0, 1, 5, size, size + 1}) {
+            std::vector<int> test(size);
+            for (int& num : test) {
+                num = std::rand() % 100;
+            }
+            std::vector<int> expected = test;
+            std::sort(expected.begin(), expected.end());
+            expected.resize(std::min(std::max(test_k, 0), size));
+
+            std::vector<int> copy = test;
+            partial_sort(copy.data(), size, test_k);
+            assert(std::vector<int>(copy.begin(), copy.begin() + expected.size()) == expected);
+            // No elements are added or removed
+            std::sort(copy.begin(), copy.end());
+            verify_sort_and_elements(test, copy.data(), size);
+
+            TopK top(test_k);
+            for (int num : test) {
+                top.push(num);
+            }
+            assert(top.sorted() == expected);
+        }
+    }
+
+    // Smallest k of a large array: partial sort and streaming against a full heap sort
+    std::vector<int> large_test(large_test_size);
+    double partial_time = 0.0, stream_time = 0.0, sort_time = 0.0;
+    for (int run = 0; run < num_runs; run++) {
+        for (int& num : large_test) {
+            num = std::rand();
+        }
+        std::vector<int> partial_copy = large_test;
+        std::vector<int> sort_copy = large_test;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        partial_sort(partial_copy.data(), large_test_size, k);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed_time = end_time - start_time;
+        partial_time += elapsed_time.count();
+
+        start_time = std::chrono::high_resolution_clock::now();
+        TopK top(k);
+        for (int num : large_test) {
+            top.push(num);
+        }
+        std::vector<int> smallest = top.sorted();
+        end_time = std::chrono::high_resolution_clock::now();
+        elapsed_time = end_time - start_time;
+        stream_time += elapsed_time.count();
+
+        start_time = std::chrono::high_resolution_clock::now();
+        heap_sort(sort_copy.data(), large_test_size);
+        end_time = std::chrono::high_resolution_clock::now();
+        elapsed_time = end_time - start_time;
+        sort_time += elapsed_time.count();
+
+        for (int i = 0; i < k; i++) {
+            assert(partial_copy[i] == sort_copy[i]);
+            assert(smallest[i] == sort_copy[i]);
+        }
+    }
+    std::cout << "Average time to find the smallest " << k << " of " << large_test_size
+              << " elements: partial_sort " << partial_time / num_runs << " seconds, TopK "
+              << stream_time / num_runs << " seconds (heap_sort: " << sort_time / num_runs << " seconds)\n";
+}
+
 int main() {
     test_heap_sort();
+    test_partial_sort_and_top_k();
     std::cout << "All tests passed.\n";
     return 0;
 }
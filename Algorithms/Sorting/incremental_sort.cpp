@@ -0,0 +1,335 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <cstdint>
+
+// Ranges up to this size are insertion sorted in one go
+#define INSERTION_THRESHOLD 16
+// Work units done between clock reads in step_for()
+#define STEP_CHUNK 4096
+
+// Quick sort that runs in bounded slices so it can share a thread with an event loop
+// All state lives in the object: a stack of pending ranges and the partition in
+// progress, which can be paused after any element. Ranges are finished left to
+// right, so array[0...sorted_prefix()) is final and can be consumed before the
+// rest of the array is sorted
+class IncrementalSorter {
+public:
+    IncrementalSorter(int *array, int size)
+        : array(array), size(size), prefix(0), partitioning(false), cancelled(false),
+          part_s(0), part_e(0), lt(0), i(0), gt(0), pivot(0), seed(0x9e3779b97f4a7c15ull) {
+        if (size > 0)
+            pending.push_back({0, size, false});
+        else
+            this->size = 0;
+    }
+
+    // Do at most about budget units of work, one unit is one element visited by
+    // a partition or one element moved by insertion sort
+    // Returns true once there is nothing left to do
+    bool step(int64_t budget) {
+        while (budget > 0) {
+            if (!partitioning) {
+                if (cancelled || pending.empty())
+                    return true;
+                Range range = pending.back();
+                pending.pop_back();
+                if (range.sorted || range.e - range.s <= INSERTION_THRESHOLD) {
+                    if (!range.sorted)
+                        budget -= __insertion_sort(range.s, range.e);
+                    // Everything left of this range is already final
+                    prefix = range.e;
+                    continue;
+                }
+                __start_partition(range.s, range.e);
+            }
+
+            // Three-way partition: [part_s, lt) < pivot, [lt, i) == pivot, [gt, part_e) > pivot
+            while (i < gt && budget > 0) {
+                int value = array[i];
+                if (value < pivot)
+                    std::swap(array[lt++], array[i++]);
+                else if (value > pivot)
+                    std::swap(array[i], array[--gt]);
+                else
+                    i++;
+                budget--;
+            }
+            if (i < gt)
+                return false;
+
+            // Push right to left so the leftmost range is processed next
+            partitioning = false;
+            if (gt < part_e)
+                pending.push_back({gt, part_e, false});
+            pending.push_back({lt, gt, true}); // Keys equal to the pivot are final
+            if (part_s < lt)
+                pending.push_back({part_s, lt, false});
+        }
+        return !partitioning && (cancelled || pending.empty());
+    }
+
+    // Work until done or until duration has passed, checking the clock every STEP_CHUNK units
+    // Returns true once there is nothing left to do
+    bool step_for(std::chrono::nanoseconds duration) {
+        auto deadline = std::chrono::steady_clock::now() + duration;
+        while (!step(STEP_CHUNK)) {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+        }
+        return true;
+    }
+
+    // Stop sorting; the array stays a permutation of the input and the sorted prefix stays valid
+    void cancel() {
+        cancelled = true;
+        partitioning = false;
+        pending.clear();
+    }
+
+    // Number of leading elements that are in their final position
+    int sorted_prefix() const {
+        return prefix;
+    }
+
+    bool finished() const {
+        return prefix == size;
+    }
+
+private:
+    struct Range {
+        int s, e;
+        bool sorted;
+    };
+
+    int *array;
+    int size;
+    int prefix;
+    std::vector<Range> pending; // Leftmost range on top
+    bool partitioning;
+    bool cancelled;
+    int part_s, part_e, lt, i, gt, pivot;
+    uint64_t seed;
+
+    // xorshift64, randomized pivots keep every input at expected O(N log N)
+    uint64_t __next_random() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    }
+
+    void __start_partition(int s_idx, int e_idx) {
+        // Median of three random elements
+        int span = e_idx - s_idx;
+        int a = array[s_idx + static_cast<int>(__next_random() % span)];
+        int b = array[s_idx + static_cast<int>(__next_random() % span)];
+        int c = array[s_idx + static_cast<int>(__next_random() % span)];
+        pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+        part_s = s_idx;
+        part_e = e_idx;
+        lt = i = s_idx;
+        gt = e_idx;
+        partitioning = true;
+    }
+
+    // Returns the work done
+    int64_t __insertion_sort(int s_idx, int e_idx) {
+        int64_t work = e_idx - s_idx;
+        for (int k = s_idx + 1; k < e_idx; k++) {
+            int insert_val = array[k];
+            int j = k;
+            while (j > s_idx && array[j - 1] > insert_val) {
+                array[j] = array[j - 1];
+                j--;
+            }
+            array[j] = insert_val;
+            work += k - j;
+        }
+        return work;
+    }
+};
+
+// Helper function to print an array
+void print_array(const int *array, int size) {
+    for (int i = 0; i < size; i++) {
+        std::cout << array[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Function to verify the array is sorted and has no added or removed elements
+void verify_sort_and_elements(const std::vector<int>& original, const int *sorted_array, int size) {
+    // Check sorted order
+    for (int i = 1; i < size; i++) {
+        assert(sorted_array[i - 1] <= sorted_array[i]);
+    }
+
+    // Check that no elements are added or removed
+    std::vector<int> sorted_copy(sorted_array, sorted_array + size);
+    std::sort(sorted_copy.begin(), sorted_copy.end());
+
+    std::vector<int> original_copy = original;
+    std::sort(original_copy.begin(), original_copy.end());
+
+    assert(sorted_copy == original_copy);
+}
+
+void fill_pattern(std::vector<int> &test, int pattern) {
+    int size = static_cast<int>(test.size());
+    for (int i = 0; i < size; i++) {
+        switch (pattern) {
+        case 0: test[i] = std::rand(); break;
+        case 1: test[i] = i; break;
+        case 2: test[i] = size - i; break;
+        case 3: test[i] = std::rand() % 4; break;
+        default: test[i] = (i < size / 2) ? i : size - i; break;
+        }
+    }
+}
+
+void test_incremental_sort() {
+    const int small_test_size = 10;
+    const int threshold_to_print = 20;
+
+    // Seed random number generator
+    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+
+    // Small random test
+    std::cout << "Small Random Test:\n";
+    std::vector<int> small_test(small_test_size);
+    for (int& num : small_test) {
+        num = std::rand() % 100; // Random numbers between 0 and 99
+    }
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "Before Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+    std::vector<int> small_test_copy = small_test;
+    IncrementalSorter small_sorter(small_test.data(), small_test_size);
+    while (!small_sorter.step(3)) {}
+    assert(small_sorter.finished());
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "After Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+    verify_sort_and_elements(small_test_copy, small_test.data(), small_test_size);
+
+    // Every pattern and budget; the prefix must only grow and always match the final order
+    std::cout << "\nStep Test:\n";
+    for (int size : {0, 1, 17, 1000, 100000}) {
+        for (int pattern = 0; pattern < 5; pattern++) {
+            for (int64_t budget : {1, 100, 10000}) {
+                if (size == 100000 && budget == 1)
+                    continue; // Same coverage as size 1000, too slow under sanitizers
+                std::vector<int> test(size);
+                fill_pattern(test, pattern);
+                std::vector<int> expected = test;
+                std::sort(expected.begin(), expected.end());
+
+                IncrementalSorter sorter(test.data(), size);
+                int last_prefix = 0;
+                while (!sorter.step(budget)) {
+                    int prefix = sorter.sorted_prefix();
+                    assert(prefix >= last_prefix);
+                    assert(std::equal(test.begin() + last_prefix, test.begin() + prefix, expected.begin() + last_prefix));
+                    last_prefix = prefix;
+                }
+                assert(sorter.finished());
+                assert(test == expected);
+            }
+        }
+    }
+
+    // Cancel midway: the input is intact and the prefix is still final
+    std::cout << "\nCancel Test:\n";
+    std::vector<int> test(100000);
+    fill_pattern(test, 0);
+    std::vector<int> original = test;
+    std::vector<int> expected = test;
+    std::sort(expected.begin(), expected.end());
+    IncrementalSorter sorter(test.data(), static_cast<int>(test.size()));
+    for (int s = 0; s < 100; s++) {
+        sorter.step(5000);
+    }
+    sorter.cancel();
+    assert(sorter.step(1000)); // Nothing left to do
+    assert(!sorter.finished());
+    assert(sorter.sorted_prefix() > 0);
+    assert(std::equal(test.begin(), test.begin() + sorter.sorted_prefix(), expected.begin()));
+    std::sort(test.begin(), test.end());
+    assert(test == expected);
+
+    // Time-budgeted steps
+    fill_pattern(test, 0);
+    expected = test;
+    std::sort(expected.begin(), expected.end());
+    IncrementalSorter timed_sorter(test.data(), static_cast<int>(test.size()));
+    while (!timed_sorter.step_for(std::chrono::microseconds(100))) {}
+    assert(test == expected);
+}
+
+void benchmark_incremental_sort() {
+    const int bench_size = 10000000;
+    std::vector<int> original(bench_size);
+    fill_pattern(original, 0);
+    std::vector<int> expected = original;
+
+    std::cout << "\nBenchmark (" << bench_size << " elements):\n";
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::sort(expected.begin(), expected.end());
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed_time = end_time - start_time;
+    double std_time = elapsed_time.count();
+    std::cout << "std::sort one shot: " << std_time << " seconds\n";
+
+    std::vector<int> test = original;
+    start_time = std::chrono::high_resolution_clock::now();
+    IncrementalSorter one_shot(test.data(), bench_size);
+    one_shot.step(INT64_MAX);
+    end_time = std::chrono::high_resolution_clock::now();
+    elapsed_time = end_time - start_time;
+    double one_shot_time = elapsed_time.count();
+    assert(test == expected);
+    std::cout << "IncrementalSorter one shot: " << one_shot_time << " seconds\n";
+
+    // Per-step latency at several budgets
+    for (int64_t budget : {10000, 100000, 1000000}) {
+        test = original;
+        std::vector<double> step_times;
+        double first_million = 0.0;
+        start_time = std::chrono::high_resolution_clock::now();
+        IncrementalSorter sorter(test.data(), bench_size);
+        while (true) {
+            auto step_start = std::chrono::high_resolution_clock::now();
+            bool done = sorter.step(budget);
+            auto step_end = std::chrono::high_resolution_clock::now();
+            step_times.push_back(std::chrono::duration<double, std::micro>(step_end - step_start).count());
+            if (first_million == 0.0 && sorter.sorted_prefix() >= 1000000)
+                first_million = std::chrono::duration<double>(step_end - start_time).count();
+            if (done)
+                break;
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        elapsed_time = end_time - start_time;
+        assert(test == expected);
+
+        std::sort(step_times.begin(), step_times.end());
+        double p99 = step_times[step_times.size() * 99 / 100];
+        std::cout << "budget " << budget << ": " << step_times.size() << " steps, p99 step "
+                  << p99 << " us, max step " << step_times.back() << " us, total " << elapsed_time.count()
+                  << " seconds (" << (elapsed_time.count() / one_shot_time - 1.0) * 100.0
+                  << "% over one shot), first 1M final after " << first_million << " seconds\n";
+    }
+}
+
+int main() {
+    test_incremental_sort();
+    benchmark_incremental_sort();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
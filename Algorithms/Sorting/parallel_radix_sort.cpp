@@ -0,0 +1,337 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <cstdint>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <sys/resource.h> // getrusage
+
+#define RADIX_BITS 8
+#define RADIX (1 << RADIX_BITS)
+// Ranges smaller than this are insertion sorted
+#define INSERTION_THRESHOLD 32
+// Ranges smaller than this are not worth spreading across threads
+#define PARALLEL_THRESHOLD (1 << 16)
+
+template <typename Key>
+inline int __digit(Key key, int shift) {
+    return static_cast<int>((key >> shift) & (RADIX - 1));
+}
+
+// Run task(t) for t in [0, num_threads), the caller runs task(0)
+template <typename Task>
+void __run_parallel(int num_threads, Task task) {
+    std::vector<std::thread> threads;
+    for (int t = 1; t < num_threads; t++) {
+        threads.emplace_back(task, t);
+    }
+    task(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+template <typename Key>
+void __insertion_sort(Key *array, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        Key insert_val = array[i];
+        size_t j = i;
+        while (j > 0 && array[j - 1] > insert_val) {
+            array[j] = array[j - 1];
+            j--;
+        }
+        array[j] = insert_val;
+    }
+}
+
+// Sequential in-place MSD radix sort (American flag sort) on the digit at shift
+// and every lower digit
+// Time complexity: O(N * sizeof(Key))
+// Space complexity: O(RADIX) per level
+template <typename Key>
+void __american_flag_sort(Key *array, size_t size, int shift) {
+    if (size < INSERTION_THRESHOLD) {
+        __insertion_sort(array, size);
+        return;
+    }
+
+    size_t counts[RADIX] = {};
+    for (size_t i = 0; i < size; i++) {
+        counts[__digit(array[i], shift)]++;
+    }
+    size_t heads[RADIX], ends[RADIX];
+    size_t sum = 0;
+    for (int b = 0; b < RADIX; b++) {
+        heads[b] = sum;
+        sum += counts[b];
+        ends[b] = sum;
+    }
+    // Follow each displaced element to its bucket until one that belongs here comes back
+    for (int b = 0; b < RADIX; b++) {
+        while (heads[b] < ends[b]) {
+            Key value = array[heads[b]];
+            int k = __digit(value, shift);
+            while (k != b) {
+                std::swap(value, array[heads[k]++]);
+                k = __digit(value, shift);
+            }
+            array[heads[b]++] = value;
+        }
+    }
+
+    if (shift == 0)
+        return;
+    size_t start = 0;
+    for (int b = 0; b < RADIX; b++) {
+        if (counts[b] > 1)
+            __american_flag_sort(array + start, counts[b], shift - RADIX_BITS);
+        start += counts[b];
+    }
+}
+
+// Distribute array by the digit at shift with num_threads cooperating, in place
+// 1. Every thread histograms its own stripe of the array
+// 2. Each bucket's unplaced region is split into one stripe per thread, and
+//    every thread permutes within its own stripes only, parking elements whose
+//    target stripe is already full at the end of the stripe (PARADIS-style)
+// 3. Each bucket moves its correct elements in front of the parked ones, the
+//    parked ones form the next, smaller unplaced region
+// Rounds repeat while they halve the unplaced elements; the little that is left
+// is finished by a sequential American flag pass
+// Fills counts with the bucket sizes
+// Space complexity: O(num_threads * RADIX)
+template <typename Key>
+void __parallel_partition(Key *array, size_t size, int shift, int num_threads, size_t *counts) {
+    std::vector<size_t> local_counts(num_threads * RADIX, 0);
+    __run_parallel(num_threads, [&](int t) {
+        size_t *local = &local_counts[t * RADIX];
+        size_t end = size * (t + 1) / num_threads;
+        for (size_t i = size * t / num_threads; i < end; i++) {
+            local[__digit(array[i], shift)]++;
+        }
+    });
+
+    size_t heads[RADIX], ends[RADIX];
+    size_t sum = 0;
+    for (int b = 0; b < RADIX; b++) {
+        counts[b] = 0;
+        for (int t = 0; t < num_threads; t++) {
+            counts[b] += local_counts[t * RADIX + b];
+        }
+        heads[b] = sum;
+        sum += counts[b];
+        ends[b] = sum;
+    }
+
+    // Per-thread stripe bounds, [stripe_head, stripe_end) is still unplaced
+    std::vector<size_t> stripe_head(num_threads * RADIX), stripe_end(num_threads * RADIX);
+    size_t remaining = size;
+    while (remaining >= PARALLEL_THRESHOLD) {
+        for (int b = 0; b < RADIX; b++) {
+            size_t unplaced = ends[b] - heads[b];
+            for (int t = 0; t < num_threads; t++) {
+                stripe_head[t * RADIX + b] = heads[b] + unplaced * t / num_threads;
+                stripe_end[t * RADIX + b] = heads[b] + unplaced * (t + 1) / num_threads;
+            }
+        }
+
+        __run_parallel(num_threads, [&](int t) {
+            size_t *head = &stripe_head[t * RADIX];
+            size_t *end = &stripe_end[t * RADIX];
+            for (int b = 0; b < RADIX; b++) {
+                while (head[b] < end[b]) {
+                    int k = __digit(array[head[b]], shift);
+                    if (k == b) {
+                        head[b]++;
+                    } else if (head[k] < end[k]) {
+                        std::swap(array[head[b]], array[head[k]++]);
+                    } else {
+                        // Target stripe is full, park the element for the next round
+                        std::swap(array[head[b]], array[--end[b]]);
+                    }
+                }
+            }
+        });
+
+        // Buckets are disjoint, so threads take every num_threads-th one
+        __run_parallel(num_threads, [&](int t) {
+            for (int b = t; b < RADIX; b += num_threads) {
+                size_t lo = heads[b], hi = ends[b];
+                while (true) {
+                    while (lo < hi && __digit(array[lo], shift) == b) lo++;
+                    while (lo < hi && __digit(array[hi - 1], shift) != b) hi--;
+                    if (lo >= hi) break;
+                    std::swap(array[lo++], array[--hi]);
+                }
+                heads[b] = lo;
+            }
+        });
+
+        size_t still_unplaced = 0;
+        for (int b = 0; b < RADIX; b++) {
+            still_unplaced += ends[b] - heads[b];
+        }
+        bool halved = still_unplaced <= remaining / 2;
+        remaining = still_unplaced;
+        if (!halved) break;
+    }
+
+    // Sequential American flag pass over what is left
+    for (int b = 0; b < RADIX; b++) {
+        while (heads[b] < ends[b]) {
+            Key value = array[heads[b]];
+            int k = __digit(value, shift);
+            while (k != b) {
+                std::swap(value, array[heads[k]++]);
+                k = __digit(value, shift);
+            }
+            array[heads[b]++] = value;
+        }
+    }
+}
+
+template <typename Key>
+void __parallel_radix_sort(Key *array, size_t size, int shift, int num_threads) {
+    if (num_threads <= 1 || size < PARALLEL_THRESHOLD) {
+        __american_flag_sort(array, size, shift);
+        return;
+    }
+
+    size_t counts[RADIX];
+    __parallel_partition(array, size, shift, num_threads, counts);
+    if (shift == 0)
+        return;
+
+    // Buckets too big for one thread get all of them, the rest are shared out
+    // largest first so the last bucket to finish is a small one
+    std::vector<std::pair<size_t, size_t>> buckets; // (size, start)
+    size_t start = 0;
+    for (int b = 0; b < RADIX; b++) {
+        if (counts[b] > size / num_threads && counts[b] >= PARALLEL_THRESHOLD)
+            __parallel_radix_sort(array + start, counts[b], shift - RADIX_BITS, num_threads);
+        else if (counts[b] > 1)
+            buckets.push_back({counts[b], start});
+        start += counts[b];
+    }
+    std::sort(buckets.begin(), buckets.end(), std::greater<std::pair<size_t, size_t>>());
+
+    std::atomic<size_t> next_bucket(0);
+    __run_parallel(num_threads, [&](int) {
+        size_t i;
+        while ((i = next_bucket.fetch_add(1)) < buckets.size()) {
+            __american_flag_sort(array + buckets[i].second, buckets[i].first, shift - RADIX_BITS);
+        }
+    });
+}
+
+// In-place parallel MSD radix sort for unsigned 32- and 64-bit keys
+// Uses all hardware threads when num_threads is 0
+// Time complexity: O(N * sizeof(Key))
+// Space complexity: O(num_threads * RADIX) per level, no N-sized buffer
+template <typename Key>
+void parallel_radix_sort(Key *array, size_t size, int num_threads = 0) {
+    static_assert(std::is_unsigned<Key>::value, "keys must be unsigned integers");
+    if (num_threads <= 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    __parallel_radix_sort(array, size, static_cast<int>(sizeof(Key) * 8) - RADIX_BITS, num_threads);
+}
+
+// Peak resident set size of the process so far, in megabytes
+double peak_rss_mb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0; // ru_maxrss is in kilobytes on Linux
+}
+
+// Function to verify the array is sorted and has no added or removed elements
+template <typename Key>
+void verify_sort_and_elements(const std::vector<Key>& original, const Key *sorted_array, size_t size) {
+    std::vector<Key> original_copy = original;
+    std::sort(original_copy.begin(), original_copy.end());
+    assert(std::equal(original_copy.begin(), original_copy.end(), sorted_array));
+    (void)size;
+}
+
+template <typename Key>
+std::vector<Key> make_keys(size_t size, int pattern, std::mt19937_64 &rng) {
+    std::vector<Key> keys(size);
+    for (size_t i = 0; i < size; i++) {
+        switch (pattern) {
+        case 0: keys[i] = static_cast<Key>(rng()); break;                         // uniform
+        case 1: keys[i] = static_cast<Key>(rng() % 1000); break;                  // high digits all zero
+        case 2: keys[i] = static_cast<Key>(42); break;                            // all equal
+        case 3: keys[i] = static_cast<Key>(i); break;                             // sorted
+        default: keys[i] = static_cast<Key>(rng() % 4 == 0 ? rng() : 7); break;   // one huge bucket
+        }
+    }
+    return keys;
+}
+
+template <typename Key>
+void test_keys(const char *name) {
+    std::mt19937_64 rng(std::time(nullptr));
+    for (int pattern = 0; pattern < 5; pattern++) {
+        for (size_t size : {size_t(0), size_t(1), size_t(31), size_t(1000), size_t(1) << 20}) {
+            std::vector<Key> keys = make_keys<Key>(size, pattern, rng);
+            for (int num_threads : {1, 3, 8}) {
+                std::vector<Key> copy = keys;
+                parallel_radix_sort(copy.data(), size, num_threads);
+                verify_sort_and_elements(keys, copy.data(), size);
+            }
+        }
+    }
+    std::cout << name << " keys passed\n";
+}
+
+void test_parallel_radix_sort() {
+    std::cout << "Correctness Test:\n";
+    test_keys<uint32_t>("32-bit");
+    test_keys<uint64_t>("64-bit");
+}
+
+template <typename Key>
+void benchmark_keys(const char *name, size_t size) {
+    std::mt19937_64 rng(std::time(nullptr));
+    std::vector<Key> keys = make_keys<Key>(size, 0, rng);
+    std::vector<Key> copy = keys;
+    double rss_before = peak_rss_mb();
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    parallel_radix_sort(keys.data(), size);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> radix_time = end_time - start_time;
+    double rss_after = peak_rss_mb();
+
+    start_time = std::chrono::high_resolution_clock::now();
+    std::sort(copy.begin(), copy.end());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> sort_time = end_time - start_time;
+    assert(keys == copy);
+
+    double data_mb = size * sizeof(Key) / (1024.0 * 1024.0);
+    std::cout << name << ": parallel_radix_sort " << radix_time.count() << " seconds ("
+              << size / radix_time.count() / 1e6 << " M keys/s), std::sort " << sort_time.count()
+              << " seconds; data " << data_mb << " MB, peak RSS grew by " << rss_after - rss_before << " MB\n";
+}
+
+void benchmark_parallel_radix_sort() {
+    const size_t bench_size = size_t(1) << 24;
+
+    std::cout << "\nBenchmark (" << bench_size << " keys, " << std::max(1u, std::thread::hardware_concurrency())
+              << " threads):\n";
+    benchmark_keys<uint32_t>("32-bit", bench_size);
+    benchmark_keys<uint64_t>("64-bit", bench_size);
+}
+
+int main() {
+    test_parallel_radix_sort();
+    benchmark_parallel_radix_sort();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
@@ -7,13 +7,12 @@
 #include <chrono> // For measuring execution time
 #include <cstdint>
 
-void __quick_sort(int *array, int s_idx, int e_idx) {
-    if (s_idx >= e_idx)
-        return;
-
+// Partition array[s_idx...e_idx] around the pivot array[e_idx]
+// Returns the final pivot index, smaller elements end up before it
+// Time complexity: O(N)
+int __partition(int *array, int s_idx, int e_idx) {
     int pivot_idx = e_idx;
     int left_idx = s_idx;
-    // partition
     for (int i = s_idx; i < e_idx; i++) {
         if (array[i] < array[pivot_idx]) {
             int tmp = array[i];
@@ -25,7 +24,14 @@ void __quick_sort(int *array, int s_idx, int e_idx) {
     int tmp = array[left_idx];
     array[left_idx] = array[pivot_idx];
     array[pivot_idx] = tmp;
-    pivot_idx = left_idx;
+    return left_idx;
+}
+
+void __quick_sort(int *array, int s_idx, int e_idx) {
+    if (s_idx >= e_idx)
+        return;
+
+    int pivot_idx = __partition(array, s_idx, e_idx);
     // recursively call quicksort
     __quick_sort(array, s_idx, pivot_idx - 1);
     __quick_sort(array, pivot_idx + 1, e_idx);
@@ -35,6 +41,85 @@ void quick_sort(int *array, int size) {
     __quick_sort(array, 0, size - 1);
 }
 
+void __swap(int *array, int a, int b) {
+    int tmp = array[a];
+    array[a] = array[b];
+    array[b] = tmp;
+}
+
+void __select_nth(int *array, int s_idx, int e_idx, int nth, int depth_limit);
+
+// Move a pivot with at least ~30% of the range on either side to array[e_idx]
+// Medians of groups of 5 are gathered at the front and their median is selected
+// Time complexity: O(N)
+void __median_of_medians(int *array, int s_idx, int e_idx) {
+    int num_medians = 0;
+    for (int group = s_idx; group <= e_idx; group += 5) {
+        int group_end = std::min(group + 4, e_idx);
+        // insertion sort the group of at most 5
+        for (int i = group + 1; i <= group_end; i++) {
+            for (int j = i; j > group && array[j - 1] > array[j]; j--) {
+                __swap(array, j - 1, j);
+            }
+        }
+        __swap(array, s_idx + num_medians++, group + (group_end - group) / 2);
+    }
+    int mid = s_idx + (num_medians - 1) / 2;
+    // The medians are few enough that the fallback cannot recurse forever
+    __select_nth(array, s_idx, s_idx + num_medians - 1, mid, 0);
+    __swap(array, mid, e_idx);
+}
+
+// Introselect: quickselect with median-of-three pivots, switching to
+// median-of-medians pivots once depth_limit partitions made too little progress
+void __select_nth(int *array, int s_idx, int e_idx, int nth, int depth_limit) {
+    while (s_idx < e_idx) {
+        if (depth_limit-- <= 0) {
+            __median_of_medians(array, s_idx, e_idx);
+        } else {
+            // median of three moved to e_idx, guards against sorted input
+            int mid = s_idx + (e_idx - s_idx) / 2;
+            if (array[mid] < array[s_idx])
+                __swap(array, mid, s_idx);
+            if (array[e_idx] < array[s_idx])
+                __swap(array, e_idx, s_idx);
+            if (array[mid] < array[e_idx])
+                __swap(array, mid, e_idx);
+        }
+
+        int pivot_idx = __partition(array, s_idx, e_idx);
+        if (nth == pivot_idx)
+            return;
+        if (nth < pivot_idx) {
+            e_idx = pivot_idx - 1;
+            continue;
+        }
+        // Gather the elements equal to the pivot right after it, so runs of
+        // duplicates are dropped in one pass instead of one element at a time
+        int equal_end = pivot_idx;
+        for (int i = pivot_idx + 1; i <= e_idx; i++) {
+            if (array[i] == array[pivot_idx])
+                __swap(array, i, ++equal_end);
+        }
+        if (nth <= equal_end)
+            return;
+        s_idx = equal_end + 1;
+    }
+}
+
+// Rearrange array so that array[nth] holds the value it would hold if the
+// array were sorted, with no larger element before it and no smaller one after
+// Time complexity: O(N)
+void select_nth(int *array, int size, int nth) {
+    if (nth < 0 || nth >= size)
+        return;
+    int depth_limit = 0;
+    for (int n = size; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    __select_nth(array, 0, size - 1, nth, depth_limit);
+}
+
 // Helper function to print an array
 void print_array(const int *array, int size) {
     for (int i = 0; i < size; i++) {
@@ -122,8 +207,80 @@ void test_quick_sort() {
               << average_time << " seconds\n";
 }
 
+// Check that array[nth] is in its sorted position and everything else is on the right side
+void verify_select_nth(const std::vector<int>& original, const int *array, int size, int nth) {
+    std::vector<int> sorted_copy = original;
+    std::sort(sorted_copy.begin(), sorted_copy.end());
+    assert(array[nth] == sorted_copy[nth]);
+    for (int i = 0; i < size; i++) {
+        assert(i > nth || array[i] <= array[nth]);
+        assert(i < nth || array[i] >= array[nth]);
+    }
+    std::vector<int> selected(array, array + size);
+    std::sort(selected.begin(), selected.end());
+    assert(selected == sorted_copy);
+}
+
+void test_select_nth() {
+    const int large_test_size = 1000000;
+    const int num_runs = 10;
+
+    std::cout << "\nSelect Nth Test:\n";
+    // Random, sorted, reversed, all-equal and few-distinct inputs
+    for (int pattern = 0; pattern < 5; pattern++) {
+        for (int size : {1, 2, 5, 6, 100, 10000}) {
+            std::vector<int> test(size);
+            for (int i = 0; i < size; i++) {
+                switch (pattern) {
+                case 0: test[i] = std::rand(); break;
+                case 1: test[i] = i; break;
+                case 2: test[i] = size - i; break;
+                case 3: test[i] = 7; break;
+                default: test[i] = std::rand() % 3; break;
+                }
+            }
+            for (int nth : {0, size / 2, size - 1}) {
+                std::vector<int> copy = test;
+                select_nth(copy.data(), size, nth);
+                verify_select_nth(test, copy.data(), size, nth);
+                // Force the median-of-medians fallback from the start
+                copy = test;
+                __select_nth(copy.data(), 0, size - 1, nth, 0);
+                verify_select_nth(test, copy.data(), size, nth);
+            }
+        }
+    }
+
+    // Compare the median against a full sort
+    std::vector<int> large_test(large_test_size);
+    double select_time = 0.0, sort_time = 0.0;
+    for (int run = 0; run < num_runs; run++) {
+        for (int& num : large_test) {
+            num = std::rand();
+        }
+        std::vector<int> large_test_copy = large_test;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        select_nth(large_test.data(), large_test_size, large_test_size / 2);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed_time = end_time - start_time;
+        select_time += elapsed_time.count();
+
+        int median = large_test[large_test_size / 2];
+        start_time = std::chrono::high_resolution_clock::now();
+        quick_sort(large_test_copy.data(), large_test_size);
+        end_time = std::chrono::high_resolution_clock::now();
+        elapsed_time = end_time - start_time;
+        sort_time += elapsed_time.count();
+        assert(median == large_test_copy[large_test_size / 2]);
+    }
+    std::cout << "Average time to find the median of " << large_test_size << " elements: "
+              << select_time / num_runs << " seconds (quick_sort: " << sort_time / num_runs << " seconds)\n";
+}
+
 int main() {
     test_quick_sort();
+    test_select_nth();
     std::cout << "All tests passed.\n";
     return 0;
 }
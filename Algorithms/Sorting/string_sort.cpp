@@ -0,0 +1,285 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Buckets smaller than this are left to multikey quicksort
+#define MSD_RADIX_THRESHOLD 1024
+// Ranges smaller than this are insertion sorted
+#define INSERTION_THRESHOLD 16
+
+// Character of s at depth shifted up by one, 0 once s has ended
+// so shorter strings sort before their extensions
+inline int __char_at(std::string_view s, int depth) {
+    return depth < static_cast<int>(s.size()) ? static_cast<unsigned char>(s[depth]) + 1 : 0;
+}
+
+inline void __swap(std::string_view *array, int a, int b) {
+    std::string_view tmp = array[a];
+    array[a] = array[b];
+    array[b] = tmp;
+}
+
+// Number of characters after depth that all strings share
+// Uses memcmp-style mismatch, which is much faster than one character per pass
+int __common_prefix(const std::string_view *array, int size, int depth) {
+    std::string_view first = array[0].substr(std::min<size_t>(depth, array[0].size()));
+    size_t common = first.size();
+    for (int i = 1; i < size && common > 0; i++) {
+        std::string_view other = array[i].substr(std::min<size_t>(depth, array[i].size()));
+        size_t limit = std::min(common, other.size());
+        common = std::mismatch(first.begin(), first.begin() + limit, other.begin()).first - first.begin();
+    }
+    return static_cast<int>(common);
+}
+
+// Insertion sort for strings that share their first depth characters
+void __insertion_sort(std::string_view *array, int size, int depth) {
+    for (int i = 1; i < size; i++) {
+        std::string_view insert_val = array[i];
+        std::string_view suffix = insert_val.substr(depth);
+        int j = i;
+        while (j > 0 && suffix < array[j - 1].substr(depth)) {
+            array[j] = array[j - 1];
+            j--;
+        }
+        array[j] = insert_val;
+    }
+}
+
+// Sort strings that share their first depth characters
+// Three-way partition on the character at depth; the equal part moves on to the
+// next character, so a shared prefix is inspected once per string instead of
+// once per comparison
+void __multikey_quicksort(std::string_view *array, int size, int depth) {
+    while (size >= INSERTION_THRESHOLD) {
+        // median of three characters as pivot
+        int a = __char_at(array[0], depth);
+        int b = __char_at(array[size / 2], depth);
+        int c = __char_at(array[size - 1], depth);
+        int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        // array[0...lt) < pivot, array[lt...i) == pivot, array[gt...size) > pivot
+        int lt = 0, i = 0, gt = size;
+        while (i < gt) {
+            int ch = __char_at(array[i], depth);
+            if (ch < pivot)
+                __swap(array, lt++, i++);
+            else if (ch > pivot)
+                __swap(array, i, --gt);
+            else
+                i++;
+        }
+
+        __multikey_quicksort(array, lt, depth);
+        __multikey_quicksort(array + gt, size - gt, depth);
+        // Strings that ended at depth are equal, otherwise continue one character deeper
+        if (pivot == 0)
+            return;
+        // When nothing was split off the strings likely share a longer prefix,
+        // skip all of it at once
+        bool unsplit = (lt == 0 && gt == size);
+        array += lt;
+        size = gt - lt;
+        depth++;
+        if (unsplit)
+            depth += __common_prefix(array, size, depth);
+    }
+    __insertion_sort(array, size, depth);
+}
+
+// Time complexity: O(D + N log N) for D distinguishing characters
+// Space complexity: O(log N) stack
+void multikey_quicksort(std::string_view *array, int size) {
+    __multikey_quicksort(array, size, 0);
+}
+
+// MSD radix sort for strings that share their first depth characters
+// The character at depth is read once per string into cache, so the
+// counting and distribution passes do not chase string pointers twice
+void __msd_radix_sort(std::string_view *array, std::string_view *buffer, uint16_t *cache, int size, int depth) {
+    if (size < MSD_RADIX_THRESHOLD) {
+        __multikey_quicksort(array, size, depth);
+        return;
+    }
+
+    int counts[257] = {};
+    for (int i = 0; i < size; i++) {
+        cache[i] = static_cast<uint16_t>(__char_at(array[i], depth));
+        counts[cache[i]]++;
+    }
+    // A single non-empty bucket means a shared prefix, skip past all of it
+    if (cache[0] != 0 && counts[cache[0]] == size) {
+        __msd_radix_sort(array, buffer, cache, size, depth + 1 + __common_prefix(array, size, depth + 1));
+        return;
+    }
+    int offsets[257];
+    int sum = 0;
+    for (int b = 0; b < 257; b++) {
+        offsets[b] = sum;
+        sum += counts[b];
+    }
+    for (int i = 0; i < size; i++) {
+        buffer[offsets[cache[i]]++] = array[i];
+    }
+    std::copy(buffer, buffer + size, array);
+
+    // Bucket 0 holds the strings that ended at depth, they are all equal
+    int start = counts[0];
+    for (int b = 1; b < 257; b++) {
+        if (counts[b] > 1)
+            __msd_radix_sort(array + start, buffer + start, cache + start, counts[b], depth + 1);
+        start += counts[b];
+    }
+}
+
+// Time complexity: O(D + N) for D distinguishing characters, plus the small buckets
+// Space complexity: O(N)
+void msd_radix_sort(std::string_view *array, int size) {
+    if (size <= 1)
+        return;
+    std::vector<std::string_view> buffer(size);
+    std::vector<uint16_t> cache(size);
+    __msd_radix_sort(array, buffer.data(), cache.data(), size, 0);
+}
+
+// Helper function to print an array
+void print_array(const std::string_view *array, int size) {
+    for (int i = 0; i < size; i++) {
+        std::cout << array[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Function to verify the array is sorted and has no added or removed elements
+void verify_sort_and_elements(const std::vector<std::string_view>& original, const std::string_view *sorted_array, int size) {
+    // Check sorted order
+    for (int i = 1; i < size; i++) {
+        assert(sorted_array[i - 1] <= sorted_array[i]);
+    }
+
+    // Check that no elements are added or removed
+    std::vector<std::string_view> sorted_copy(sorted_array, sorted_array + size);
+    std::sort(sorted_copy.begin(), sorted_copy.end());
+
+    std::vector<std::string_view> original_copy = original;
+    std::sort(original_copy.begin(), original_copy.end());
+
+    assert(sorted_copy == original_copy);
+}
+
+// Datasets with the shared prefixes typical of real keys
+std::vector<std::string> make_dataset(int kind, int size) {
+    static const char *hosts[] = {"www.example.com", "api.example.com", "cdn.example.net", "example.org"};
+    static const char *paths[] = {"users", "orders", "products", "search", "static/img"};
+    std::vector<std::string> strings(size);
+    for (std::string &s : strings) {
+        switch (kind) {
+        case 0: // URLs
+            s = std::string("https://") + hosts[std::rand() % 4] + "/" + paths[std::rand() % 5] + "/" +
+                std::to_string(std::rand() % 100000) + "?page=" + std::to_string(std::rand() % 50);
+            break;
+        case 1: // Zero-padded IDs
+        {
+            std::string id = std::to_string(std::rand() % 10000000);
+            s = "user-" + std::string(12 - id.size(), '0') + id;
+            break;
+        }
+        default: // Random short strings, including empty ones and binary bytes
+            s.resize(std::rand() % 12);
+            for (char &c : s) {
+                c = static_cast<char>(std::rand() % 256);
+            }
+            break;
+        }
+    }
+    return strings;
+}
+
+void test_string_sort() {
+    const int small_test_size = 10;
+    const int large_test_size = 100000;
+    const int threshold_to_print = 20;
+
+    // Seed random number generator
+    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+
+    // Small test
+    std::cout << "Small Test:\n";
+    std::vector<std::string> small_strings = {"banana", "apple", "", "app", "apples", "band",
+                                              "bandana", "apple", "a", "ban"};
+    std::vector<std::string_view> small_test(small_strings.begin(), small_strings.end());
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "Before Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+    std::vector<std::string_view> small_test_copy = small_test;
+    multikey_quicksort(small_test.data(), small_test_size);
+    if (small_test_size <= threshold_to_print) {
+        std::cout << "After Sorting:\n";
+        print_array(small_test.data(), small_test_size);
+    }
+    verify_sort_and_elements(small_test_copy, small_test.data(), small_test_size);
+    msd_radix_sort(small_test_copy.data(), small_test_size);
+    assert(small_test_copy == small_test);
+
+    // Large tests on every dataset
+    std::cout << "\nLarge Test:\n";
+    for (int kind = 0; kind < 3; kind++) {
+        std::vector<std::string> strings = make_dataset(kind, large_test_size);
+        std::vector<std::string_view> original(strings.begin(), strings.end());
+
+        std::vector<std::string_view> by_multikey = original;
+        multikey_quicksort(by_multikey.data(), large_test_size);
+        verify_sort_and_elements(original, by_multikey.data(), large_test_size);
+
+        std::vector<std::string_view> by_radix = original;
+        msd_radix_sort(by_radix.data(), large_test_size);
+        verify_sort_and_elements(original, by_radix.data(), large_test_size);
+    }
+}
+
+void benchmark_string_sort() {
+    const int bench_size = 1000000;
+    const int num_runs = 3;
+    const char *names[] = {"URLs", "IDs", "random"};
+
+    std::cout << "\nBenchmark (" << bench_size << " strings):\n";
+    for (int kind = 0; kind < 3; kind++) {
+        std::vector<std::string> strings = make_dataset(kind, bench_size);
+        std::vector<std::string_view> original(strings.begin(), strings.end());
+        double times[3] = {};
+
+        for (int run = 0; run < num_runs; run++) {
+            for (int algo = 0; algo < 3; algo++) {
+                std::vector<std::string_view> test = original;
+                auto start_time = std::chrono::high_resolution_clock::now();
+                if (algo == 0)
+                    std::sort(test.begin(), test.end());
+                else if (algo == 1)
+                    multikey_quicksort(test.data(), bench_size);
+                else
+                    msd_radix_sort(test.data(), bench_size);
+                auto end_time = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> elapsed_time = end_time - start_time;
+                times[algo] += elapsed_time.count();
+            }
+        }
+
+        std::cout << names[kind] << ": std::sort " << times[0] / num_runs << " seconds, multikey_quicksort "
+                  << times[1] / num_runs << " seconds, msd_radix_sort " << times[2] / num_runs << " seconds\n";
+    }
+}
+
+int main() {
+    test_string_sort();
+    benchmark_string_sort();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
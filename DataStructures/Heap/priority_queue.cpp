@@ -0,0 +1,606 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <cstdint>
+#include <functional> // std::less
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <set>
+#include <type_traits>
+#include <utility>
+
+// Priority queues for schedulers and shortest-path searches
+// All of them are min-queues: top() is the element no other element is ordered
+// before under Compare. Pass std::greater<T> for a max-queue like std::priority_queue
+
+// d-ary heap primitives, the generalization of heapify() and build_max_heap()
+// from heap_sort.cpp to any arity and comparator
+// Both move a hole instead of swapping, so each level costs one move
+// Children of i are D * i + 1 ... D * i + D
+
+// Move the element at idx down until no child is ordered before it
+// Time complexity: O(D log_D N)
+template <int D, typename T, typename Compare, typename OnMove>
+void __sift_down(T *array, size_t idx, size_t size, Compare &comp, OnMove on_move) {
+    T value = std::move(array[idx]);
+    while (true) {
+        size_t first = D * idx + 1;
+        if (first >= size)
+            break;
+        size_t last = std::min(first + D, size);
+        size_t best = first;
+        for (size_t child = first + 1; child < last; child++) {
+            if (comp(array[child], array[best]))
+                best = child;
+        }
+        if (!comp(array[best], value))
+            break;
+        array[idx] = std::move(array[best]);
+        on_move(idx);
+        idx = best;
+    }
+    array[idx] = std::move(value);
+    on_move(idx);
+}
+
+// Move the element at idx up until its parent is not ordered after it
+// Time complexity: O(log_D N)
+template <int D, typename T, typename Compare, typename OnMove>
+void __sift_up(T *array, size_t idx, Compare &comp, OnMove on_move) {
+    T value = std::move(array[idx]);
+    while (idx > 0) {
+        size_t parent = (idx - 1) / D;
+        if (!comp(value, array[parent]))
+            break;
+        array[idx] = std::move(array[parent]);
+        on_move(idx);
+        idx = parent;
+    }
+    array[idx] = std::move(value);
+    on_move(idx);
+}
+
+// Floyd's bottom-up construction
+// Time complexity: O(N)
+template <int D, typename T, typename Compare, typename OnMove>
+void __build_heap(T *array, size_t size, Compare &comp, OnMove on_move) {
+    if (size <= 1)
+        return;
+    for (size_t i = (size - 2) / D + 1; i-- > 0;) {
+        __sift_down<D>(array, i, size, comp, on_move);
+    }
+}
+
+struct __NoTracking {
+    void operator()(size_t) const {}
+};
+
+// Array-backed d-ary heap
+// Wider nodes make the tree shallower, so push is cheaper and pop scans more
+// children per level; D = 4 keeps a node's children in one cache line for small T
+template <typename T, int D = 4, typename Compare = std::less<T>>
+class DaryHeap {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+private:
+    std::vector<T> heap;
+    Compare comp;
+
+public:
+    explicit DaryHeap(const Compare &comp = Compare()) : comp(comp) {}
+
+    // Bulk build from [first, last)
+    // Time complexity: O(N)
+    template <typename InputIt>
+    DaryHeap(InputIt first, InputIt last, const Compare &comp = Compare()) : heap(first, last), comp(comp) {
+        __build_heap<D>(heap.data(), heap.size(), this->comp, __NoTracking());
+    }
+
+    // Add every element of [first, last) and rebuild the heap
+    // Time complexity: O(N + M)
+    template <typename InputIt>
+    void push_bulk(InputIt first, InputIt last) {
+        heap.insert(heap.end(), first, last);
+        __build_heap<D>(heap.data(), heap.size(), comp, __NoTracking());
+    }
+
+    // Time complexity: O(log_D N)
+    void push(T value) {
+        heap.push_back(std::move(value));
+        __sift_up<D>(heap.data(), heap.size() - 1, comp, __NoTracking());
+    }
+
+    // Time complexity: O(1)
+    const T &top() const {
+        assert(!heap.empty());
+        return heap[0];
+    }
+
+    // Time complexity: O(D log_D N)
+    void pop() {
+        assert(!heap.empty());
+        heap[0] = std::move(heap.back());
+        heap.pop_back();
+        if (!heap.empty())
+            __sift_down<D>(heap.data(), 0, heap.size(), comp, __NoTracking());
+    }
+
+    size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+    void reserve(size_t capacity) { heap.reserve(capacity); }
+    void clear() { heap.clear(); }
+
+    // Bytes held by the heap storage
+    size_t memory_usage() const { return heap.capacity() * sizeof(T); }
+};
+
+// d-ary heap whose elements can be changed or removed through handles
+// push() returns a handle that stays valid until its element is popped or
+// erased; handles are then reused. A position table maps handles to heap slots
+template <typename T, int D = 4, typename Compare = std::less<T>>
+class AddressableHeap {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+public:
+    typedef uint32_t handle;
+    static constexpr handle INVALID = std::numeric_limits<handle>::max();
+
+private:
+    struct Entry {
+        T value;
+        handle id;
+    };
+
+    // Orders entries by their values
+    struct EntryCompare {
+        Compare comp;
+        bool operator()(const Entry &a, const Entry &b) { return comp(a.value, b.value); }
+    };
+
+    std::vector<Entry> heap;
+    std::vector<handle> positions; // Heap slot of each handle, INVALID if free
+    std::vector<handle> free_handles;
+    EntryCompare comp;
+
+    auto tracker() {
+        return [this](size_t idx) { positions[heap[idx].id] = static_cast<handle>(idx); };
+    }
+
+    // Move the element at idx to where it belongs after its value changed
+    void restore(size_t idx) {
+        if (idx > 0 && comp(heap[idx], heap[(idx - 1) / D]))
+            __sift_up<D>(heap.data(), idx, comp, tracker());
+        else
+            __sift_down<D>(heap.data(), idx, heap.size(), comp, tracker());
+    }
+
+    // Remove the element at idx and free its handle
+    void remove_at(size_t idx) {
+        positions[heap[idx].id] = INVALID;
+        free_handles.push_back(heap[idx].id);
+        if (idx + 1 == heap.size()) {
+            heap.pop_back();
+            return;
+        }
+        heap[idx] = std::move(heap.back());
+        heap.pop_back();
+        restore(idx);
+    }
+
+public:
+    explicit AddressableHeap(const Compare &comp = Compare()) : comp{comp} {}
+
+    // Time complexity: O(log_D N)
+    handle push(T value) {
+        handle id;
+        if (!free_handles.empty()) {
+            id = free_handles.back();
+            free_handles.pop_back();
+        } else {
+            id = static_cast<handle>(positions.size());
+            positions.push_back(INVALID);
+        }
+        heap.push_back({std::move(value), id});
+        __sift_up<D>(heap.data(), heap.size() - 1, comp, tracker());
+        return id;
+    }
+
+    // Time complexity: O(1)
+    const T &top() const {
+        assert(!heap.empty());
+        return heap[0].value;
+    }
+
+    handle top_handle() const {
+        assert(!heap.empty());
+        return heap[0].id;
+    }
+
+    // Time complexity: O(D log_D N)
+    void pop() {
+        assert(!heap.empty());
+        remove_at(0);
+    }
+
+    bool contains(handle id) const {
+        return id < positions.size() && positions[id] != INVALID;
+    }
+
+    const T &get(handle id) const {
+        assert(contains(id));
+        return heap[positions[id]].value;
+    }
+
+    // Move an element toward the top, value must not be ordered after its current value
+    // Time complexity: O(log_D N)
+    void decrease_key(handle id, T value) {
+        assert(contains(id) && !comp.comp(heap[positions[id]].value, value));
+        size_t idx = positions[id];
+        heap[idx].value = std::move(value);
+        __sift_up<D>(heap.data(), idx, comp, tracker());
+    }
+
+    // Change an element's value in either direction
+    // Time complexity: O(D log_D N)
+    void update(handle id, T value) {
+        assert(contains(id));
+        size_t idx = positions[id];
+        heap[idx].value = std::move(value);
+        restore(idx);
+    }
+
+    // Time complexity: O(D log_D N)
+    void erase(handle id) {
+        assert(contains(id));
+        remove_at(positions[id]);
+    }
+
+    size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+
+    void reserve(size_t capacity) {
+        heap.reserve(capacity);
+        positions.reserve(capacity);
+    }
+
+    // Bytes held by the heap, the position table and the free list
+    size_t memory_usage() const {
+        return heap.capacity() * sizeof(Entry) + (positions.capacity() + free_handles.capacity()) * sizeof(handle);
+    }
+};
+
+// Radix heap for monotone integer priorities: every pushed key must be at least
+// the last key popped, as in Dijkstra's algorithm or event simulation
+// Bucket i holds keys whose highest bit differing from the last popped key is
+// bit i - 1. Refilling bucket 0 redistributes one bucket into strictly lower
+// ones, so every element moves at most once per bit
+// Time complexity: O(1) push, O(log C) amortized pop for keys up to C
+template <typename Key, typename Value>
+class RadixHeap {
+    static_assert(std::is_unsigned<Key>::value, "radix heaps need unsigned keys");
+    static constexpr int NUM_BUCKETS = std::numeric_limits<Key>::digits + 1;
+
+public:
+    typedef std::pair<Key, Value> value_type;
+
+private:
+    std::vector<value_type> buckets[NUM_BUCKETS];
+    Key last;
+    size_t count;
+
+    // Bit width of key ^ last
+    static int bucket_index(Key key, Key last) {
+        Key diff = key ^ last;
+#if defined(__GNUC__)
+        return diff == 0 ? 0 : 64 - __builtin_clzll(static_cast<unsigned long long>(diff));
+#else
+        int index = 0;
+        while (diff != 0) {
+            diff >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    // Make bucket 0 non-empty, it then holds the elements with the minimum key
+    void pull() {
+        if (!buckets[0].empty())
+            return;
+        int i = 1;
+        while (buckets[i].empty()) i++;
+        Key minimum = buckets[i][0].first;
+        for (const value_type &kv : buckets[i]) {
+            minimum = std::min(minimum, kv.first);
+        }
+        last = minimum;
+        for (value_type &kv : buckets[i]) {
+            buckets[bucket_index(kv.first, last)].push_back(std::move(kv));
+        }
+        buckets[i].clear();
+    }
+
+public:
+    RadixHeap() : last(0), count(0) {}
+
+    // Time complexity: O(1) plus O(log C) to find the bucket
+    void push(Key key, Value value) {
+        assert(key >= last); // Keys must not go below the last one popped
+        buckets[bucket_index(key, last)].emplace_back(key, std::move(value));
+        count++;
+    }
+
+    // Element with the minimum key
+    const value_type &top() {
+        assert(count > 0);
+        pull();
+        return buckets[0].back();
+    }
+
+    // Remove and return the element with the minimum key
+    value_type pop() {
+        assert(count > 0);
+        pull();
+        value_type kv = std::move(buckets[0].back());
+        buckets[0].pop_back();
+        count--;
+        return kv;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Bytes held by the bucket storage
+    size_t memory_usage() const {
+        size_t bytes = 0;
+        for (const std::vector<value_type> &bucket : buckets) {
+            bytes += bucket.capacity() * sizeof(value_type);
+        }
+        return bytes;
+    }
+};
+
+// std::priority_queue with access to its container, for memory accounting
+template <typename T, typename Compare>
+struct MeasuredPriorityQueue : std::priority_queue<T, std::vector<T>, Compare> {
+    size_t memory_usage() const { return this->c.capacity() * sizeof(T); }
+};
+
+// Test framework for DaryHeap against std::priority_queue
+template <int D>
+void test_dary_heap() {
+    DaryHeap<int, D> heap;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> expected;
+    for (int op = 0; op < 100000; op++) {
+        if (expected.empty() || std::rand() % 3 != 0) {
+            int value = std::rand() % 1000; // Many duplicates
+            heap.push(value);
+            expected.push(value);
+        } else {
+            assert(heap.top() == expected.top());
+            heap.pop();
+            expected.pop();
+        }
+        assert(heap.size() == expected.size());
+    }
+
+    // Bulk build and bulk push pop in order
+    std::vector<int> values(100000);
+    for (int &num : values) num = std::rand() - RAND_MAX / 2;
+    DaryHeap<int, D> built(values.begin(), values.end());
+    built.push_bulk(values.begin(), values.begin() + 1000);
+    std::vector<int> sorted = values;
+    sorted.insert(sorted.end(), values.begin(), values.begin() + 1000);
+    std::sort(sorted.begin(), sorted.end());
+    for (int value : sorted) {
+        assert(built.top() == value);
+        built.pop();
+    }
+    assert(built.empty());
+
+    // Max-queue with a custom comparator and a move-only type
+    DaryHeap<std::unique_ptr<int>, D, bool (*)(const std::unique_ptr<int> &, const std::unique_ptr<int> &)> owners(
+        [](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) { return *a > *b; });
+    for (int i = 0; i < 100; i++) owners.push(std::make_unique<int>((i * 37) % 100));
+    for (int i = 99; i >= 0; i--) {
+        assert(*owners.top() == i);
+        owners.pop();
+    }
+}
+
+// Test framework for AddressableHeap against std::multiset
+void test_addressable_heap() {
+    AddressableHeap<int> heap;
+    std::multiset<int> expected;
+    std::vector<AddressableHeap<int>::handle> live;
+    for (int op = 0; op < 100000; op++) {
+        int action = std::rand() % 6;
+        if (live.empty() || action < 2) {
+            int value = std::rand() % 100000;
+            live.push_back(heap.push(value));
+            expected.insert(value);
+        } else {
+            size_t pick = std::rand() % live.size();
+            AddressableHeap<int>::handle id = live[pick];
+            int old_value = heap.get(id);
+            expected.erase(expected.find(old_value));
+            if (action == 2) {
+                int value = old_value - std::rand() % 1000;
+                heap.decrease_key(id, value);
+                expected.insert(value);
+            } else if (action == 3) {
+                int value = std::rand() % 100000;
+                heap.update(id, value);
+                expected.insert(value);
+            } else if (action == 4) {
+                heap.erase(id);
+                assert(!heap.contains(id));
+                live[pick] = live.back();
+                live.pop_back();
+            } else {
+                expected.insert(old_value);
+                AddressableHeap<int>::handle top = heap.top_handle();
+                assert(heap.top() == *expected.begin());
+                expected.erase(expected.begin());
+                heap.pop();
+                assert(!heap.contains(top));
+                live.erase(std::find(live.begin(), live.end(), top));
+            }
+        }
+        assert(heap.size() == expected.size());
+        assert(heap.empty() || heap.top() == *expected.begin());
+    }
+    // Handles are reused, so the table only grows to the peak size
+    while (!heap.empty()) heap.pop();
+    for (int i = 0; i < 10; i++) assert(heap.push(i) < 100000);
+}
+
+// Test framework for RadixHeap, keys only grow like in Dijkstra's algorithm
+template <typename Key>
+void test_radix_heap() {
+    RadixHeap<Key, int> heap;
+    std::priority_queue<std::pair<Key, int>, std::vector<std::pair<Key, int>>, std::greater<std::pair<Key, int>>> expected;
+    Key big = static_cast<Key>(std::numeric_limits<Key>::max() - 1000);
+    Key last = 0;
+    heap.push(0, 0);
+    expected.push({0, 0});
+    for (int op = 0; op < 100000; op++) {
+        if (!expected.empty() && std::rand() % 2 == 0) {
+            std::pair<Key, int> kv = heap.pop();
+            assert(kv.first == expected.top().first && kv.first >= last);
+            last = kv.first;
+            expected.pop();
+            // Push a few keys above the one just popped, some near the key limit
+            for (int i = std::rand() % 3; i > 0; i--) {
+                Key key = (std::rand() % 100 == 0) ? big + std::rand() % 1000 : kv.first + std::rand() % 1000;
+                if (key < kv.first) key = kv.first;
+                heap.push(key, op);
+                expected.push({key, op});
+            }
+        } else if (expected.empty()) {
+            heap.push(std::max(big, last), op);
+            expected.push({std::max(big, last), op});
+        }
+        assert(heap.size() == expected.size());
+    }
+    while (!expected.empty()) {
+        assert(heap.top().first == expected.top().first);
+        assert(heap.pop().first == expected.top().first);
+        expected.pop();
+    }
+    assert(heap.empty());
+}
+
+void test_priority_queue() {
+    // Seed random number generator
+    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+
+    std::cout << "D-ary Heap Test:\n";
+    test_dary_heap<2>();
+    test_dary_heap<3>();
+    test_dary_heap<4>();
+    test_dary_heap<8>();
+
+    std::cout << "\nAddressable Heap Test:\n";
+    test_addressable_heap();
+
+    std::cout << "\nRadix Heap Test:\n";
+    test_radix_heap<uint32_t>();
+    test_radix_heap<uint64_t>();
+}
+
+// Fill with N keys, then alternate pop and push of a larger key (hold model), then drain
+template <typename Queue, typename Push, typename Pop>
+void benchmark_queue(const char *name, Queue &queue, const std::vector<uint32_t> &keys, Push push, Pop pop) {
+    size_t n = keys.size();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (uint32_t key : keys) push(queue, key);
+    auto mid_time = std::chrono::high_resolution_clock::now();
+    size_t bytes = queue.memory_usage();
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t key = pop(queue);
+        checksum += key;
+        push(queue, key + keys[i] % 1024); // Monotone, so the radix heap can run it too
+    }
+    while (!queue.empty()) checksum += pop(queue);
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> fill_time = mid_time - start_time;
+    std::chrono::duration<double> hold_time = end_time - mid_time;
+    std::cout << name << ": push " << n / fill_time.count() / 1e6 << " M/s, pop+push/drain "
+              << 3 * n / hold_time.count() / 1e6 << " M ops/s, " << static_cast<double>(bytes) / n
+              << " bytes/element (checksum " << checksum % 1000 << ")\n";
+}
+
+void benchmark_priority_queue() {
+    const size_t bench_size = 1000000;
+
+    std::cout << "\nBenchmark (" << bench_size << " uint32_t keys):\n";
+    std::vector<uint32_t> keys(bench_size);
+    for (uint32_t &key : keys) key = static_cast<uint32_t>(std::rand()) >> 1;
+
+    {
+        MeasuredPriorityQueue<uint32_t, std::greater<uint32_t>> queue;
+        benchmark_queue("std::priority_queue", queue, keys,
+                        [](auto &q, uint32_t key) { q.push(key); },
+                        [](auto &q) { uint32_t key = q.top(); q.pop(); return key; });
+    }
+    {
+        DaryHeap<uint32_t, 2> queue;
+        benchmark_queue("DaryHeap<2>        ", queue, keys,
+                        [](auto &q, uint32_t key) { q.push(key); },
+                        [](auto &q) { uint32_t key = q.top(); q.pop(); return key; });
+    }
+    {
+        DaryHeap<uint32_t, 4> queue;
+        benchmark_queue("DaryHeap<4>        ", queue, keys,
+                        [](auto &q, uint32_t key) { q.push(key); },
+                        [](auto &q) { uint32_t key = q.top(); q.pop(); return key; });
+    }
+    {
+        DaryHeap<uint32_t, 8> queue;
+        benchmark_queue("DaryHeap<8>        ", queue, keys,
+                        [](auto &q, uint32_t key) { q.push(key); },
+                        [](auto &q) { uint32_t key = q.top(); q.pop(); return key; });
+    }
+    {
+        AddressableHeap<uint32_t, 4> queue;
+        benchmark_queue("AddressableHeap<4> ", queue, keys,
+                        [](auto &q, uint32_t key) { q.push(key); },
+                        [](auto &q) { uint32_t key = q.top(); q.pop(); return key; });
+    }
+    {
+        RadixHeap<uint32_t, uint32_t> queue;
+        benchmark_queue("RadixHeap          ", queue, keys,
+                        [](auto &q, uint32_t key) { q.push(key, key); },
+                        [](auto &q) { return q.pop().first; });
+    }
+
+    // Bulk build against pushing one at a time
+    auto start_time = std::chrono::high_resolution_clock::now();
+    DaryHeap<uint32_t, 4> built(keys.begin(), keys.end());
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> build_time = end_time - start_time;
+    start_time = std::chrono::high_resolution_clock::now();
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> std_built(
+        std::greater<uint32_t>(), std::vector<uint32_t>(keys.begin(), keys.end()));
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> std_build_time = end_time - start_time;
+    assert(built.top() == std_built.top());
+    std::cout << "Bulk build: DaryHeap<4> " << build_time.count() << " seconds, std::priority_queue "
+              << std_build_time.count() << " seconds\n";
+}
+
+int main() {
+    test_priority_queue();
+    benchmark_priority_queue();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
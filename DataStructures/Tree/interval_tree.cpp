@@ -0,0 +1,636 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <chrono> // For measuring execution time
+#include <limits>
+#include <utility>
+
+// Enum to represent the color of a node
+enum class Color {
+    RED,
+    BLACK
+};
+
+// Closed interval [start, end]
+template <typename T>
+struct Interval {
+    T start;
+    T end;
+};
+
+// Interval tree: a red-black tree keyed on (start, end) where every node also
+// stores the largest end point in its subtree. Duplicate intervals are allowed.
+// T and V must be default constructible for the sentinel nil node.
+//
+// The red-black machinery is a copy of the one in red_black_tree.cpp rather than
+// a layer on RBTree. Every .cpp in this repository is a standalone program with
+// its own main() and there are no headers to share code through. RBTree also has
+// unique keys and no hook in its rotations or fixups, and max_end has to be
+// recomputed at exactly those points. Fixes to the shared rebalancing logic need
+// to be made in both files.
+template <typename T, typename V>
+class IntervalTree {
+private:
+    // Structure for a node in the interval tree
+    struct Node {
+        Interval<T> interval;
+        V value;
+        T max_end;                   // Largest interval.end in this subtree
+        Color color;                 // Color of the node (RED or BLACK)
+        Node *left, *right, *parent; // Pointers to children and parent
+
+        Node(const Interval<T> &interval, const V &value, Color color, Node *nil)
+            : interval(interval), value(value), max_end(interval.end), color(color),
+              left(nil), right(nil), parent(nil) {}
+    };
+
+    Node *root;
+    Node *nil; // Sentinel nil node used for leaves, its max_end is the lowest T
+    size_t node_count;
+
+    static bool less(const Interval<T> &a, const Interval<T> &b) {
+        return a.start < b.start || (a.start == b.start && a.end < b.end);
+    }
+
+    // Recompute max_end of node from its children
+    // Time complexity: O(1)
+    void update_max(Node *node) {
+        node->max_end = std::max(node->interval.end, std::max(node->left->max_end, node->right->max_end));
+    }
+
+    // Recompute max_end from node up to the root
+    // Time complexity: O(log N)
+    void update_max_upwards(Node *node) {
+        while (node != nil) {
+            update_max(node);
+            node = node->parent;
+        }
+    }
+
+    // Time complexity: O(1), keeps max_end correct for x and y
+    void rotate_left(Node *x) {
+        Node *y = x->right;
+        x->right = y->left;
+        if (y->left != nil)
+            y->left->parent = x;
+        y->parent = x->parent;
+        if (x->parent == nil)
+            root = y;
+        else if (x == x->parent->left)
+            x->parent->left = y;
+        else
+            x->parent->right = y;
+        y->left = x;
+        x->parent = y;
+        // y now covers exactly the subtree x used to cover
+        y->max_end = x->max_end;
+        update_max(x);
+    }
+
+    // Time complexity: O(1), keeps max_end correct for x and y
+    void rotate_right(Node *x) {
+        Node *y = x->left;
+        x->left = y->right;
+        if (y->right != nil)
+            y->right->parent = x;
+        y->parent = x->parent;
+        if (x->parent == nil)
+            root = y;
+        else if (x == x->parent->right)
+            x->parent->right = y;
+        else
+            x->parent->left = y;
+        y->right = x;
+        x->parent = y;
+        y->max_end = x->max_end;
+        update_max(x);
+    }
+
+    // Restore the red-black properties after inserting the red node z
+    void insert_fixup(Node *z) {
+        while (z->parent->color == Color::RED) {
+            Node *grandparent = z->parent->parent;
+            if (z->parent == grandparent->left) {
+                Node *uncle = grandparent->right;
+                if (uncle->color == Color::RED) {
+                    z->parent->color = Color::BLACK;
+                    uncle->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    z = grandparent;
+                } else {
+                    if (z == z->parent->right) {
+                        z = z->parent;
+                        rotate_left(z);
+                    }
+                    z->parent->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    rotate_right(grandparent);
+                }
+            } else {
+                Node *uncle = grandparent->left;
+                if (uncle->color == Color::RED) {
+                    z->parent->color = Color::BLACK;
+                    uncle->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    z = grandparent;
+                } else {
+                    if (z == z->parent->left) {
+                        z = z->parent;
+                        rotate_right(z);
+                    }
+                    z->parent->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    rotate_left(grandparent);
+                }
+            }
+        }
+        root->color = Color::BLACK;
+    }
+
+    // Replace the subtree rooted at u with the subtree rooted at v
+    void transplant(Node *u, Node *v) {
+        if (u->parent == nil)
+            root = v;
+        else if (u == u->parent->left)
+            u->parent->left = v;
+        else
+            u->parent->right = v;
+        v->parent = u->parent; // May write nil->parent, which remove_fixup relies on
+    }
+
+    Node *minimum(Node *node) const {
+        while (node->left != nil)
+            node = node->left;
+        return node;
+    }
+
+    // Next node in order, nil after the maximum
+    Node *successor(Node *node) const {
+        if (node->right != nil)
+            return minimum(node->right);
+        Node *parent = node->parent;
+        while (parent != nil && node == parent->right) {
+            node = parent;
+            parent = parent->parent;
+        }
+        return parent;
+    }
+
+    // Restore the red-black properties after removing a black node above x
+    void remove_fixup(Node *x) {
+        while (x != root && x->color == Color::BLACK) {
+            if (x == x->parent->left) {
+                Node *sibling = x->parent->right;
+                if (sibling->color == Color::RED) {
+                    sibling->color = Color::BLACK;
+                    x->parent->color = Color::RED;
+                    rotate_left(x->parent);
+                    sibling = x->parent->right;
+                }
+                if (sibling->left->color == Color::BLACK && sibling->right->color == Color::BLACK) {
+                    sibling->color = Color::RED;
+                    x = x->parent;
+                } else {
+                    if (sibling->right->color == Color::BLACK) {
+                        sibling->left->color = Color::BLACK;
+                        sibling->color = Color::RED;
+                        rotate_right(sibling);
+                        sibling = x->parent->right;
+                    }
+                    sibling->color = x->parent->color;
+                    x->parent->color = Color::BLACK;
+                    sibling->right->color = Color::BLACK;
+                    rotate_left(x->parent);
+                    x = root;
+                }
+            } else {
+                Node *sibling = x->parent->left;
+                if (sibling->color == Color::RED) {
+                    sibling->color = Color::BLACK;
+                    x->parent->color = Color::RED;
+                    rotate_right(x->parent);
+                    sibling = x->parent->left;
+                }
+                if (sibling->right->color == Color::BLACK && sibling->left->color == Color::BLACK) {
+                    sibling->color = Color::RED;
+                    x = x->parent;
+                } else {
+                    if (sibling->left->color == Color::BLACK) {
+                        sibling->right->color = Color::BLACK;
+                        sibling->color = Color::RED;
+                        rotate_left(sibling);
+                        sibling = x->parent->left;
+                    }
+                    sibling->color = x->parent->color;
+                    x->parent->color = Color::BLACK;
+                    sibling->left->color = Color::BLACK;
+                    rotate_right(x->parent);
+                    x = root;
+                }
+            }
+        }
+        x->color = Color::BLACK;
+    }
+
+    // Build a perfectly balanced subtree from sorted[lo..hi]
+    // Leaves differ in depth by at most one, so coloring the nodes on the deepest
+    // level red and everything else black satisfies every red-black property
+    Node *build_balanced(const std::vector<std::pair<Interval<T>, V>> &sorted, size_t lo, size_t hi,
+                         int depth, int red_depth, Node *parent) {
+        if (lo >= hi) return nil;
+        size_t mid = lo + (hi - lo) / 2;
+        Color color = (depth == red_depth) ? Color::RED : Color::BLACK;
+        Node *node = new Node(sorted[mid].first, sorted[mid].second, color, nil);
+        node->parent = parent;
+        node->left = build_balanced(sorted, lo, mid, depth + 1, red_depth, node);
+        node->right = build_balanced(sorted, mid + 1, hi, depth + 1, red_depth, node);
+        update_max(node);
+        return node;
+    }
+
+public:
+    IntervalTree() : node_count(0) {
+        nil = new Node(Interval<T>{T(), std::numeric_limits<T>::lowest()}, V(), Color::BLACK, nullptr);
+        nil->left = nil->right = nil->parent = nil;
+        nil->max_end = std::numeric_limits<T>::lowest();
+        root = nil;
+    }
+
+    IntervalTree(const IntervalTree &) = delete;
+    IntervalTree &operator=(const IntervalTree &) = delete;
+
+    ~IntervalTree() {
+        clear();
+        delete nil;
+    }
+
+    size_t size() const {
+        return node_count;
+    }
+
+    // Destroy all nodes in O(N) time and O(1) extra memory
+    void clear() {
+        Node *node = root;
+        while (node != nil) {
+            if (node->left == nil) {
+                Node *right = node->right;
+                delete node;
+                node = right;
+            } else {
+                Node *left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            }
+        }
+        root = nil;
+        node_count = 0;
+    }
+
+    // Insert an interval with its value, duplicates are kept
+    // Time complexity: O(log N)
+    void insert(const Interval<T> &interval, const V &value) {
+        assert(!(interval.end < interval.start));
+        Node *parent = nil;
+        Node *current = root;
+        while (current != nil) {
+            // The new interval ends up below current, so its max only grows
+            if (current->max_end < interval.end)
+                current->max_end = interval.end;
+            parent = current;
+            current = less(interval, current->interval) ? current->left : current->right;
+        }
+
+        Node *node = new Node(interval, value, Color::RED, nil);
+        node->parent = parent;
+        if (parent == nil)
+            root = node;
+        else if (less(interval, parent->interval))
+            parent->left = node;
+        else
+            parent->right = node;
+        node_count++;
+        insert_fixup(node);
+    }
+
+    // Delete one interval equal to interval and holding value, returns false if there is none
+    // Time complexity: O(log N + d) for d duplicates of interval
+    bool remove(const Interval<T> &interval, const V &value) {
+        // Find the first node not less than interval, duplicates follow it in order
+        Node *z = nil;
+        Node *current = root;
+        while (current != nil) {
+            if (less(current->interval, interval)) {
+                current = current->right;
+            } else {
+                z = current;
+                current = current->left;
+            }
+        }
+        while (z != nil && !less(interval, z->interval) && !(z->value == value))
+            z = successor(z);
+        if (z == nil || less(interval, z->interval)) return false;
+
+        Node *y = z;
+        Node *x;
+        Color removed_color = y->color;
+        if (z->left == nil) {
+            x = z->right;
+            transplant(z, z->right);
+        } else if (z->right == nil) {
+            x = z->left;
+            transplant(z, z->left);
+        } else {
+            y = minimum(z->right);
+            removed_color = y->color;
+            x = y->right;
+            if (y->parent == z) {
+                x->parent = y;
+            } else {
+                transplant(y, y->right);
+                y->right = z->right;
+                y->right->parent = y;
+            }
+            transplant(z, y);
+            y->left = z->left;
+            y->left->parent = y;
+            y->color = z->color;
+        }
+        // x->parent is the lowest node whose subtree lost an interval
+        update_max_upwards(x->parent);
+        delete z;
+        node_count--;
+        if (removed_color == Color::BLACK)
+            remove_fixup(x);
+        return true;
+    }
+
+    // Replace the contents with intervals already sorted by (start, end)
+    // Time complexity: O(N)
+    void build(const std::vector<std::pair<Interval<T>, V>> &sorted) {
+        clear();
+        for (size_t i = 1; i < sorted.size(); i++) {
+            assert(!less(sorted[i].first, sorted[i - 1].first));
+        }
+        if (sorted.empty()) return;
+        // Depth of the deepest level, counting the root as depth 0
+        int max_depth = 0;
+        while ((size_t(2) << max_depth) - 1 < sorted.size())
+            max_depth++;
+        // A full deepest level needs no red nodes
+        int red_depth = ((size_t(2) << max_depth) - 1 == sorted.size()) ? -1 : max_depth;
+        root = build_balanced(sorted, 0, sorted.size(), 0, red_depth, nil);
+        node_count = sorted.size();
+    }
+
+    // Call visitor(interval, value) for every interval overlapping [lo, hi],
+    // in ascending order of start
+    // Subtrees whose max_end is below lo are skipped and the walk stops at the
+    // first start past hi; matches starting inside [lo, hi] cost O(1) each, the
+    // ones reaching in from the left cost at most a root-to-leaf path each
+    // Time complexity: O(log N + k) for k matches starting inside [lo, hi],
+    //                  O(min(N, k log N)) in the worst case
+    template <typename Visitor>
+    void overlap(const T &lo, const T &hi, Visitor visitor) const {
+        std::vector<Node *> stack;
+        Node *node = root;
+        while (true) {
+            while (node != nil && !(node->max_end < lo)) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            if (stack.empty()) break;
+            node = stack.back();
+            stack.pop_back();
+            // Every later node in order starts after hi
+            if (hi < node->interval.start) break;
+            if (!(node->interval.end < lo))
+                visitor(node->interval, node->value);
+            node = node->right;
+        }
+    }
+
+    // Call visitor(interval, value) for every interval containing point
+    template <typename Visitor>
+    void stab(const T &point, Visitor visitor) const {
+        overlap(point, point, visitor);
+    }
+
+    // Validate the red-black properties and the max_end augmentation
+    void validate() const {
+        // Property 1: Root is always black
+        assert(root == nil || root->color == Color::BLACK);
+
+        // Walk the tree with an explicit stack, tracking black nodes above each node
+        int black_height = -1;
+        size_t count = 0;
+        std::vector<std::pair<Node *, int>> stack;
+        stack.push_back({root, 0});
+        while (!stack.empty()) {
+            Node *current = stack.back().first;
+            int depth = stack.back().second;
+            stack.pop_back();
+            if (current == nil) {
+                // Property 4: Equal black height on every path
+                if (black_height < 0)
+                    black_height = depth;
+                assert(black_height == depth);
+                continue;
+            }
+            count++;
+            // Property 3: Red nodes cannot have red children
+            if (current->color == Color::RED) {
+                assert(current->left->color == Color::BLACK);
+                assert(current->right->color == Color::BLACK);
+            }
+            assert(current->left == nil || !less(current->interval, current->left->interval));
+            assert(current->right == nil || !less(current->right->interval, current->interval));
+            assert(current->left == nil || current->left->parent == current);
+            assert(current->right == nil || current->right->parent == current);
+            T expected = std::max(current->interval.end,
+                                  std::max(current->left->max_end, current->right->max_end));
+            assert(current->max_end == expected);
+            depth += (current->color == Color::BLACK ? 1 : 0);
+            stack.push_back({current->right, depth});
+            stack.push_back({current->left, depth});
+        }
+        assert(count == node_count);
+    }
+};
+
+typedef std::vector<std::pair<Interval<int>, int>> IntervalList;
+
+// Brute-force reference: ids of intervals overlapping [lo, hi]
+std::vector<int> linear_overlap(const IntervalList &intervals, int lo, int hi) {
+    std::vector<int> result;
+    for (const auto &entry : intervals) {
+        if (entry.first.start <= hi && lo <= entry.first.end)
+            result.push_back(entry.second);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<int> tree_overlap(const IntervalTree<int, int> &tree, int lo, int hi) {
+    std::vector<int> result;
+    tree.overlap(lo, hi, [&](const Interval<int> &, int id) { result.push_back(id); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+IntervalList random_intervals(int count, int range, int max_length) {
+    IntervalList intervals(count);
+    for (int i = 0; i < count; i++) {
+        int start = std::rand() % range;
+        intervals[i] = {{start, start + std::rand() % max_length}, i};
+    }
+    return intervals;
+}
+
+// Test framework for the interval tree
+void test_interval_tree() {
+    const int test_size = 20000;
+    const int range = 1000000;
+
+    // Small test
+    std::cout << "Small Test:\n";
+    IntervalTree<int, int> small;
+    small.insert({15, 20}, 0);
+    small.insert({10, 30}, 1);
+    small.insert({17, 19}, 2);
+    small.insert({5, 20}, 3);
+    small.insert({12, 15}, 4);
+    small.insert({30, 40}, 5);
+    small.validate();
+    std::vector<int> found;
+    small.stab(18, [&](const Interval<int> &interval, int id) {
+        std::cout << "[" << interval.start << ", " << interval.end << "] ";
+        found.push_back(id);
+    });
+    std::cout << std::endl;
+    std::sort(found.begin(), found.end());
+    assert((found == std::vector<int>{0, 1, 2, 3}));
+
+    // Random inserts, removes and queries against a linear scan
+    std::cout << "\nRandom Test:\n";
+    IntervalList intervals = random_intervals(test_size, range, 5000);
+    IntervalTree<int, int> tree;
+    for (const auto &entry : intervals) {
+        tree.insert(entry.first, entry.second);
+    }
+    tree.validate();
+    for (int run = 0; run < 200; run++) {
+        int lo = std::rand() % range;
+        int hi = lo + std::rand() % 10000;
+        assert(tree_overlap(tree, lo, hi) == linear_overlap(intervals, lo, hi));
+        assert(tree_overlap(tree, lo, lo) == linear_overlap(intervals, lo, lo));
+    }
+
+    // Duplicates and removal
+    IntervalList kept;
+    for (const auto &entry : intervals) {
+        if (entry.second % 3 == 0) {
+            bool removed = tree.remove(entry.first, entry.second);
+            assert(removed);
+        } else {
+            kept.push_back(entry);
+        }
+    }
+    bool removed = tree.remove(intervals[0].first, intervals[0].second);
+    assert(!removed);
+    tree.insert(kept[0].first, -1);
+    tree.insert(kept[0].first, -2);
+    removed = tree.remove(kept[0].first, -1);
+    assert(removed);
+    removed = tree.remove(kept[0].first, -2);
+    assert(removed);
+    tree.validate();
+    assert(tree.size() == kept.size());
+    for (int run = 0; run < 200; run++) {
+        int lo = std::rand() % range;
+        int hi = lo + std::rand() % 10000;
+        assert(tree_overlap(tree, lo, hi) == linear_overlap(kept, lo, hi));
+    }
+
+    // Bulk build from sorted intervals
+    std::cout << "\nBulk Build Test:\n";
+    for (int size : {0, 1, 2, 3, 7, 8, 1000, test_size}) {
+        IntervalList sorted(intervals.begin(), intervals.begin() + size);
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<Interval<int>, int> &a,
+                                                   const std::pair<Interval<int>, int> &b) {
+            return a.first.start < b.first.start ||
+                   (a.first.start == b.first.start && a.first.end < b.first.end);
+        });
+        IntervalTree<int, int> built;
+        built.build(sorted);
+        built.validate();
+        for (int run = 0; run < 20; run++) {
+            int lo = std::rand() % range;
+            int hi = lo + std::rand() % 10000;
+            assert(tree_overlap(built, lo, hi) == linear_overlap(sorted, lo, hi));
+        }
+        // Built trees stay valid under updates
+        built.insert({range / 2, range / 2 + 10}, -1);
+        built.validate();
+    }
+}
+
+// Compare query time against the linear scan the tree replaces
+void benchmark_interval_tree() {
+    const int bench_size = 1000000;
+    const int num_queries = 1000;
+    const int range = 100000000;
+
+    std::cout << "\nBenchmark (" << bench_size << " intervals, " << num_queries << " queries):\n";
+    IntervalList intervals = random_intervals(bench_size, range, 10000);
+    std::sort(intervals.begin(), intervals.end(), [](const std::pair<Interval<int>, int> &a,
+                                                     const std::pair<Interval<int>, int> &b) {
+        return a.first.start < b.first.start || (a.first.start == b.first.start && a.first.end < b.first.end);
+    });
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    IntervalTree<int, int> tree;
+    tree.build(intervals);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> build_time = end_time - start_time;
+
+    std::vector<int> points(num_queries);
+    for (int &point : points) {
+        point = std::rand() % range;
+    }
+
+    long long tree_matches = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int point : points) {
+        tree.stab(point, [&](const Interval<int> &, int) { tree_matches++; });
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> tree_time = end_time - start_time;
+
+    long long linear_matches = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int point : points) {
+        for (const auto &entry : intervals) {
+            if (entry.first.start <= point && point <= entry.first.end)
+                linear_matches++;
+        }
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> linear_time = end_time - start_time;
+    assert(tree_matches == linear_matches);
+
+    std::cout << "Bulk build: " << build_time.count() << " seconds\n";
+    std::cout << "Stabbing queries: tree " << tree_time.count() << " seconds, linear scan "
+              << linear_time.count() << " seconds (" << tree_matches << " matches)\n";
+}
+
+int main() {
+    std::srand(static_cast<unsigned int>(std::time(nullptr))); // Seed RNG
+    test_interval_tree();
+    benchmark_interval_tree();
+    std::cout << "All tests passed.\n";
+    return 0;
+}
@@ -1,9 +1,33 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdlib>
 #include <ctime>
 #include <chrono> // For measuring execution time
+#include <deque>
+#include <functional> // std::less
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, madvise, munmap
+#include <sys/stat.h> // fstat, fchmod
+#include <unistd.h>   // close, fsync
 
 // Enum to represent the color of a node
 enum class Color {
@@ -11,96 +35,1550 @@ enum class Color {
     BLACK
 };
 
-// Structure for a node in the red-black tree
-struct Node {
-    int data;                 // Value of the node
-    Color color;              // Color of the node (RED or BLACK)
-    Node *left, *right, *parent; // Pointers to children and parent
+// On-disk format (version 2):
+//   [RBFileHeader][RBDiskNode<K, V> x node_count]
+// Nodes are written in pre-order so every subtree occupies a contiguous run of
+// records. Child links are byte offsets relative to the record that holds them
+// (0 means nil), so the file can be mapped at any address and searched in place.
+const char RB_FILE_MAGIC[8] = {'R', 'B', 'T', 'R', 'E', 'E', '\0', '\0'};
+const uint32_t RB_FILE_VERSION = 2; // Version 2 added key/value payloads
 
-    Node(int data, Color color, Node *nil)
-        : data(data), color(color), left(nil), right(nil), parent(nil) {}
+struct RBFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t node_size;        // sizeof(RBDiskNode<K, V>) of the writer
+    uint32_t key_size;         // sizeof(K) of the writer
+    uint32_t value_size;       // sizeof(V) of the writer
+    uint64_t node_count;
+    uint64_t root_offset;      // Byte offset of the root record from the file start, 0 if empty
+    uint64_t payload_checksum; // FNV-1a over all node records
+    uint64_t header_checksum;  // FNV-1a over all preceding header fields
 };
 
-// Structure for the red-black tree
+// Only trivial key and value types can be stored, they are copied byte for byte
+template <typename K, typename V>
+struct RBDiskNode {
+    K key;
+    V value;
+    int64_t left;  // Relative byte offset of the left child, 0 for nil
+    int64_t right; // Relative byte offset of the right child, 0 for nil
+    uint32_t color;
+};
+
+// 64-bit FNV-1a hash used as the file checksum
+uint64_t fnv1a_64(const void *buf, size_t len, uint64_t hash = 14695981039346656037ULL) {
+    const unsigned char *p = static_cast<const unsigned char *>(buf);
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Snapshot of an RBTree's memory use, shape and event counters, see RBTree::stats()
+struct RBTreeStats {
+    uint64_t node_count;
+    uint64_t node_bytes;       // sizeof one node, allocator overhead excluded
+    uint64_t payload_bytes;    // sizeof one key/value pair
+    uint64_t bytes_allocated;  // All nodes, the sentinel is shared
+    double bytes_per_key;
+    int black_height;          // Black nodes on every root-to-leaf path, nil excluded
+    // Shape, filled in only when stats() walks the tree; the root has depth 0
+    bool has_shape;
+    int max_depth;
+    double average_depth;
+    std::vector<uint64_t> depth_histogram; // Nodes at each depth
+    // Counted since construction or the last reset_counters()
+    uint64_t rotations;        // From insert and remove rebalancing
+    uint64_t recolors;
+    uint64_t lookups;
+    uint64_t lookup_path_nodes; // Nodes visited by all lookups
+    uint64_t max_lookup_path;
+    double average_lookup_path;
+
+    // Single-line JSON object, for logging and graphing
+    std::string to_json() const {
+        std::ostringstream out;
+        out << "{\"node_count\":" << node_count << ",\"node_bytes\":" << node_bytes
+            << ",\"payload_bytes\":" << payload_bytes << ",\"bytes_allocated\":" << bytes_allocated
+            << ",\"bytes_per_key\":" << bytes_per_key << ",\"black_height\":" << black_height;
+        if (has_shape) {
+            out << ",\"max_depth\":" << max_depth << ",\"average_depth\":" << average_depth
+                << ",\"depth_histogram\":[";
+            for (size_t i = 0; i < depth_histogram.size(); i++) {
+                out << (i ? "," : "") << depth_histogram[i];
+            }
+            out << "]";
+        }
+        out << ",\"rotations\":" << rotations << ",\"recolors\":" << recolors << ",\"lookups\":" << lookups
+            << ",\"lookup_path_nodes\":" << lookup_path_nodes << ",\"max_lookup_path\":" << max_lookup_path
+            << ",\"average_lookup_path\":" << average_lookup_path << "}";
+        return out.str();
+    }
+};
+
+// Worker threads shared by every RBTree, used by the parallel set operations
+// A forking thread queues one half of its work and runs the other half itself;
+// while the queued half is pending it runs queued tasks too, so nested forks
+// never leave every thread blocked
+class TaskPool {
+public:
+    struct Task {
+        std::function<void()> run;
+        bool done = false; // Guarded by the pool mutex
+    };
+
+    // hardware_concurrency() - 1 workers, the forking thread makes up the rest
+    static TaskPool &shared() {
+        static TaskPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    void submit(Task *task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(task);
+        work_ready.notify_one();
+    }
+
+    // Return once task has run, running queued tasks in the meantime
+    void wait(Task *task) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!task->done) {
+            if (queue.empty()) {
+                task_done.wait(lock);
+                continue;
+            }
+            // Newest first, which is usually the caller's own task
+            Task *next = queue.back();
+            queue.pop_back();
+            execute(next, lock);
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_ready.notify_all();
+        for (std::thread &worker : workers) worker.join();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable work_ready, task_done;
+    std::deque<Task *> queue;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    explicit TaskPool(unsigned num_workers) {
+        for (unsigned i = 0; i < num_workers; i++) workers.emplace_back([this] { work(); });
+    }
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    // Workers take the oldest task, which is the largest one
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            work_ready.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return;
+            Task *next = queue.front();
+            queue.pop_front();
+            execute(next, lock);
+        }
+    }
+
+    // Run task with the mutex released
+    void execute(Task *task, std::unique_lock<std::mutex> &lock) {
+        lock.unlock();
+        task->run();
+        lock.lock();
+        task->done = true;
+        task_done.notify_all();
+    }
+};
+
+// Structure for the red-black tree, an ordered map from K to V
+// Compare may be transparent (e.g. std::less<>), in which case lookups accept
+// any type comparable with K, such as std::string_view for std::string keys
+template <typename K, typename V, typename Compare = std::less<K>>
 class RBTree {
+public:
+    typedef std::pair<const K, V> value_type;
+
 private:
+    // Structure for a node in the red-black tree
+    struct Node {
+        Color color;                 // Color of the node (RED or BLACK)
+        Node *left, *right, *parent; // Pointers to children and parent
+        // Key/value payload, left unconstructed in the sentinel nil node so
+        // K and V do not have to be default constructible
+        union {
+            value_type kv;
+        };
+
+        // Sentinel constructor
+        Node() : color(Color::BLACK), left(nullptr), right(nullptr), parent(nullptr) {}
+
+        // Constructs the payload in place from args
+        template <typename... Args>
+        Node(Node *nil, Args &&...args)
+            : color(Color::RED), left(nil), right(nil), parent(nil), kv(std::forward<Args>(args)...) {}
+
+        ~Node() {} // The tree destroys kv, only it knows which node is the sentinel
+    };
+
+    // Sentinel nil node used for leaves. It is shared by every tree of this type
+    // and never written, so nodes can move between trees as they are
+    static inline Node nil_node;
+    static constexpr Node *nil = &nil_node;
+    // split() cannot count the nodes it moves in O(log N), it leaves both
+    // trees at UNKNOWN_COUNT and the next size() or finished stats_step()
+    // counts them. Those are const and may run on several reader threads at
+    // once, so the count is a relaxed atomic: racing readers store the same
+    // value, and writers, which never overlap readers, need no locked updates
+    static constexpr size_t UNKNOWN_COUNT = SIZE_MAX;
+
     Node *root;
-    Node *nil; // Sentinel nil node used for leaves
+    mutable std::atomic<size_t> node_count;
+    Compare comp;
 
-    // Recursive helper to validate black height consistency
-    int validate_black_height(Node *node) const {
-        if (node == nil) return 1; // Base case: nil nodes have black height 1
+    // Bumped by every change to the links, so a paused ShapeWalk can tell
+    // that the nodes it points to may be gone
+    uint64_t version;
+
+    // Event counters behind stats(). They are relaxed atomics updated with a
+    // plain load and store instead of a locked read-modify-write, which keeps
+    // the hot paths cheap. Rotations and recolors come from writers only;
+    // lookups are const and run on many threads at once, so each thread
+    // records them in its own cache line, one of LOOKUP_SHARDS, and stats()
+    // adds the shards up. Threads sharing a shard may lose a few increments.
+    // The shards take over 1 KB, so they are allocated by the first lookup and
+    // trees that are only built, split or joined never carry them
+    static constexpr size_t LOOKUP_SHARDS = 16;
+    struct alignas(64) LookupShard {
+        std::atomic<uint64_t> lookups{0};
+        std::atomic<uint64_t> path_nodes{0};
+        std::atomic<uint64_t> max_path{0};
+    };
+    struct Counters {
+        std::atomic<uint64_t> rotations{0};
+        std::atomic<uint64_t> recolors{0};
+        std::atomic<LookupShard *> lookup_shards{nullptr}; // LOOKUP_SHARDS of them, or nullptr
+    };
+    mutable Counters counters;
 
-        int left_height = validate_black_height(node->left);
-        int right_height = validate_black_height(node->right);
+    static void bump(std::atomic<uint64_t> &counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Threads are given shards round robin on their first lookup
+    static size_t thread_shard() {
+        static std::atomic<size_t> next_shard{0};
+        thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % LOOKUP_SHARDS;
+        return shard;
+    }
+
+    // Install the shards if no other reader has yet, returns the installed ones
+    LookupShard *allocate_lookup_shards() const {
+        LookupShard *fresh = new LookupShard[LOOKUP_SHARDS];
+        LookupShard *installed = nullptr;
+        if (counters.lookup_shards.compare_exchange_strong(installed, fresh, std::memory_order_acq_rel,
+                                                           std::memory_order_acquire))
+            return fresh;
+        delete[] fresh;
+        return installed;
+    }
+
+    void record_lookup(uint64_t path_length) const {
+        LookupShard *shards = counters.lookup_shards.load(std::memory_order_acquire);
+        if (!shards)
+            shards = allocate_lookup_shards();
+        LookupShard &shard = shards[thread_shard()];
+        bump(shard.lookups, 1);
+        bump(shard.path_nodes, path_length);
+        if (path_length > shard.max_path.load(std::memory_order_relaxed))
+            shard.max_path.store(path_length, std::memory_order_relaxed);
+    }
 
-        // Check if the black heights of left and right subtrees match
-        assert(left_height == right_height);
+    static void copy_counter(std::atomic<uint64_t> &to, const std::atomic<uint64_t> &from) {
+        to.store(from.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // Everything in stats() but the shape
+    // Time complexity: O(log N), or O(N) once after a split()
+    RBTreeStats counter_stats() const {
+        RBTreeStats result = {};
+        size_t count = size();
+        result.node_count = count;
+        result.node_bytes = sizeof(Node);
+        result.payload_bytes = sizeof(value_type);
+        result.bytes_allocated = count * sizeof(Node);
+        result.bytes_per_key = count ? static_cast<double>(result.bytes_allocated) / count : 0.0;
+        result.black_height = black_height(root);
 
-        // Increment black height if the current node is black
-        return left_height + (node->color == Color::BLACK ? 1 : 0);
+        result.rotations = counters.rotations.load(std::memory_order_relaxed);
+        result.recolors = counters.recolors.load(std::memory_order_relaxed);
+        const LookupShard *shards = counters.lookup_shards.load(std::memory_order_acquire);
+        for (size_t i = 0; shards && i < LOOKUP_SHARDS; i++) {
+            result.lookups += shards[i].lookups.load(std::memory_order_relaxed);
+            result.lookup_path_nodes += shards[i].path_nodes.load(std::memory_order_relaxed);
+            result.max_lookup_path = std::max(result.max_lookup_path, shards[i].max_path.load(std::memory_order_relaxed));
+        }
+        result.average_lookup_path =
+            result.lookups ? static_cast<double>(result.lookup_path_nodes) / result.lookups : 0.0;
+        return result;
+    }
+
+    // Validate black height consistency with an explicit stack, so deep trees
+    // cannot overflow the call stack; returns the black height of node
+    int validate_black_height(Node *node) const {
+        int black_height = -1; // Black nodes on the first root-to-nil path seen, nil included
+        std::vector<std::pair<Node *, int>> stack; // Node and black nodes above it
+        stack.push_back({node, 0});
+        while (!stack.empty()) {
+            Node *current = stack.back().first;
+            int depth = stack.back().second;
+            stack.pop_back();
+            if (current == nil) {
+                // Every path from node to a nil must have the same number of black nodes
+                if (black_height < 0)
+                    black_height = depth + 1; // nil nodes are black
+                assert(black_height == depth + 1);
+                continue;
+            }
+            depth += (current->color == Color::BLACK ? 1 : 0);
+            stack.push_back({current->right, depth});
+            stack.push_back({current->left, depth});
+        }
+        return black_height;
     }
 
-    // Recursive helper to validate red-black property
+    // Validate the red-black property, the search order and the parent links
+    // by walking the tree in order; needs O(1) extra memory
     void validate_red_black_property(Node *node) const {
         if (node == nil) return;
 
-        // If a node is red, both its children must be black
-        if (node->color == Color::RED) {
-            assert(node->left->color == Color::BLACK);
-            assert(node->right->color == Color::BLACK);
+        Node *prev = nil;
+        Node *end = successor(maximum(node));
+        for (Node *current = minimum(node); current != end; current = successor(current)) {
+            // If a node is red, both its children must be black
+            if (current->color == Color::RED) {
+                assert(current->left->color == Color::BLACK);
+                assert(current->right->color == Color::BLACK);
+            }
+            // Iterators rely on the parent links
+            assert(current->left == nil || current->left->parent == current);
+            assert(current->right == nil || current->right->parent == current);
+            // Keys are strictly increasing in order
+            assert(prev == nil || comp(prev->kv.first, current->kv.first));
+            prev = current;
         }
+    }
+
+    // Time complexity: O(1)
+    void rotate_left(Node *x) {
+        bump(counters.rotations, 1);
+        Node *y = x->right;
+        x->right = y->left;
+        if (y->left != nil)
+            y->left->parent = x;
+        y->parent = x->parent;
+        if (x->parent == nil)
+            root = y;
+        else if (x == x->parent->left)
+            x->parent->left = y;
+        else
+            x->parent->right = y;
+        y->left = x;
+        x->parent = y;
+    }
+
+    // Time complexity: O(1)
+    void rotate_right(Node *x) {
+        bump(counters.rotations, 1);
+        Node *y = x->left;
+        x->left = y->right;
+        if (y->right != nil)
+            y->right->parent = x;
+        y->parent = x->parent;
+        if (x->parent == nil)
+            root = y;
+        else if (x == x->parent->right)
+            x->parent->right = y;
+        else
+            x->parent->left = y;
+        y->right = x;
+        x->parent = y;
+    }
+
+    // Restore the red-black properties after inserting the red node z
+    void insert_fixup(Node *z) {
+        uint64_t recolors = 0; // Flushed to the counter once at the end
+        while (z->parent->color == Color::RED) {
+            Node *grandparent = z->parent->parent;
+            if (z->parent == grandparent->left) {
+                Node *uncle = grandparent->right;
+                if (uncle->color == Color::RED) {
+                    // Case 1: recolor and move the violation up
+                    z->parent->color = Color::BLACK;
+                    uncle->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    recolors += 3;
+                    z = grandparent;
+                } else {
+                    if (z == z->parent->right) {
+                        // Case 2: turn into case 3
+                        z = z->parent;
+                        rotate_left(z);
+                    }
+                    // Case 3
+                    z->parent->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    recolors += 2;
+                    rotate_right(grandparent);
+                }
+            } else {
+                Node *uncle = grandparent->left;
+                if (uncle->color == Color::RED) {
+                    z->parent->color = Color::BLACK;
+                    uncle->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    recolors += 3;
+                    z = grandparent;
+                } else {
+                    if (z == z->parent->left) {
+                        z = z->parent;
+                        rotate_right(z);
+                    }
+                    z->parent->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    recolors += 2;
+                    rotate_left(grandparent);
+                }
+            }
+        }
+        if (root->color == Color::RED) recolors++;
+        root->color = Color::BLACK;
+        bump(counters.recolors, recolors);
+    }
+
+    // Replace the subtree rooted at u with the subtree rooted at v
+    void transplant(Node *u, Node *v) {
+        if (u->parent == nil)
+            root = v;
+        else if (u == u->parent->left)
+            u->parent->left = v;
+        else
+            u->parent->right = v;
+        if (v != nil)
+            v->parent = u->parent;
+    }
+
+    // Put node in old's place, with old's links and color
+    void replace_node(Node *old, Node *node) {
+        version++;
+        node->color = old->color;
+        node->parent = old->parent;
+        if (old->parent == nil)
+            root = node;
+        else if (old == old->parent->left)
+            old->parent->left = node;
+        else
+            old->parent->right = node;
+        link(node, old->left, old->right);
+    }
+
+    // Both return nil for an empty subtree
+    Node *minimum(Node *node) const {
+        while (node != nil && node->left != nil)
+            node = node->left;
+        return node;
+    }
 
-        // Recursively check children
-        validate_red_black_property(node->left);
-        validate_red_black_property(node->right);
+    Node *maximum(Node *node) const {
+        while (node != nil && node->right != nil)
+            node = node->right;
+        return node;
+    }
+
+    // Next node in order, nil after the maximum
+    // Time complexity: O(log N), amortized O(1) over a full scan
+    Node *successor(Node *node) const {
+        if (node->right != nil)
+            return minimum(node->right);
+        Node *parent = node->parent;
+        while (parent != nil && node == parent->right) {
+            node = parent;
+            parent = parent->parent;
+        }
+        return parent;
+    }
+
+    // Previous node in order, nil before the minimum
+    Node *predecessor(Node *node) const {
+        if (node->left != nil)
+            return maximum(node->left);
+        Node *parent = node->parent;
+        while (parent != nil && node == parent->left) {
+            node = parent;
+            parent = parent->parent;
+        }
+        return parent;
+    }
+
+    // Restore the red-black properties after removing a black node above x
+    // x may be nil, so its parent is passed in and tracked here instead of
+    // being read from x
+    void remove_fixup(Node *x, Node *parent) {
+        uint64_t recolors = 0; // Flushed to the counter once at the end
+        while (x != root && x->color == Color::BLACK) {
+            if (x == parent->left) {
+                Node *sibling = parent->right;
+                if (sibling->color == Color::RED) {
+                    // Case 1: make the sibling black
+                    sibling->color = Color::BLACK;
+                    parent->color = Color::RED;
+                    recolors += 2;
+                    rotate_left(parent);
+                    sibling = parent->right;
+                }
+                if (sibling->left->color == Color::BLACK && sibling->right->color == Color::BLACK) {
+                    // Case 2: push the extra black up
+                    sibling->color = Color::RED;
+                    recolors++;
+                    x = parent;
+                    parent = x->parent;
+                } else {
+                    if (sibling->right->color == Color::BLACK) {
+                        // Case 3: turn into case 4
+                        sibling->left->color = Color::BLACK;
+                        sibling->color = Color::RED;
+                        recolors += 2;
+                        rotate_right(sibling);
+                        sibling = parent->right;
+                    }
+                    // Case 4
+                    sibling->color = parent->color;
+                    parent->color = Color::BLACK;
+                    sibling->right->color = Color::BLACK;
+                    recolors += 3;
+                    rotate_left(parent);
+                    x = root;
+                }
+            } else {
+                Node *sibling = parent->left;
+                if (sibling->color == Color::RED) {
+                    sibling->color = Color::BLACK;
+                    parent->color = Color::RED;
+                    recolors += 2;
+                    rotate_right(parent);
+                    sibling = parent->left;
+                }
+                if (sibling->right->color == Color::BLACK && sibling->left->color == Color::BLACK) {
+                    sibling->color = Color::RED;
+                    recolors++;
+                    x = parent;
+                    parent = x->parent;
+                } else {
+                    if (sibling->left->color == Color::BLACK) {
+                        sibling->right->color = Color::BLACK;
+                        sibling->color = Color::RED;
+                        recolors += 2;
+                        rotate_left(sibling);
+                        sibling = parent->left;
+                    }
+                    sibling->color = parent->color;
+                    parent->color = Color::BLACK;
+                    sibling->left->color = Color::BLACK;
+                    recolors += 3;
+                    rotate_right(parent);
+                    x = root;
+                }
+            }
+        }
+        if (x->color == Color::RED) {
+            x->color = Color::BLACK;
+            recolors++;
+        }
+        bump(counters.recolors, recolors);
     }
 
     // In-order traversal for debugging or validation
     void inorder_traversal(Node *node) const {
         if (node == nil) return;
-        inorder_traversal(node->left);
-        std::cout << node->data << " ";
-        inorder_traversal(node->right);
+        Node *end = successor(maximum(node));
+        for (Node *current = minimum(node); current != end; current = successor(current))
+            std::cout << current->kv.first << " ";
+    }
+
+    // Returns the node holding key or nil
+    template <typename Q>
+    Node *lookup(const Q &key) const {
+        Node *current = root;
+        uint64_t path_length = 0;
+        while (current != nil) {
+            path_length++;
+            if (comp(key, current->kv.first))
+                current = current->left;
+            else if (comp(current->kv.first, key))
+                current = current->right;
+            else
+                break;
+        }
+        record_lookup(path_length);
+        return current;
+    }
+
+    // Returns the node holding key, or nil with parent and go_left describing
+    // the empty slot where key belongs
+    template <typename Q>
+    Node *descend(const Q &key, Node *&parent, bool &go_left) const {
+        parent = nil;
+        go_left = false;
+        Node *current = root;
+        while (current != nil) {
+            if (comp(key, current->kv.first)) {
+                go_left = true;
+            } else if (comp(current->kv.first, key)) {
+                go_left = false;
+            } else {
+                return current;
+            }
+            parent = current;
+            current = go_left ? current->left : current->right;
+        }
+        return nil;
+    }
+
+    // Returns the first node whose key is not less than key, or nil
+    template <typename Q>
+    Node *lower_bound_node(const Q &key) const {
+        Node *result = nil;
+        Node *current = root;
+        while (current != nil) {
+            if (comp(current->kv.first, key)) {
+                current = current->right;
+            } else {
+                result = current;
+                current = current->left;
+            }
+        }
+        return result;
+    }
+
+    // Returns the first node whose key is greater than key, or nil
+    template <typename Q>
+    Node *upper_bound_node(const Q &key) const {
+        Node *result = nil;
+        Node *current = root;
+        while (current != nil) {
+            if (comp(key, current->kv.first)) {
+                result = current;
+                current = current->left;
+            } else {
+                current = current->right;
+            }
+        }
+        return result;
+    }
+
+    // Link a new red node into the slot found by descend() and rebalance
+    void attach(Node *node, Node *parent, bool go_left) {
+        version++;
+        node->parent = parent;
+        if (parent == nil)
+            root = node;
+        else if (go_left)
+            parent->left = node;
+        else
+            parent->right = node;
+        set_count(add_counts(known_count(), 1));
+        insert_fixup(node);
+    }
+
+    void destroy_node(Node *node) {
+        node->kv.~value_type();
+        delete node;
+    }
+
+    // Join-based set operations
+    // They work on detached subtrees and pass each subtree's black height
+    // (black nodes from its root down, nil excluded) along with it, so heights
+    // are neither stored nor recomputed. They never touch root and never write
+    // through nil, which makes disjoint subtrees safe to process on different threads
+
+    // Subtrees with fewer black levels are not worth a task
+    static constexpr int PARALLEL_MIN_BLACK_HEIGHT = 8;
+    // The set operations go key by key when one tree is this many times smaller
+    static constexpr size_t SEQUENTIAL_SIZE_RATIO = 8;
+
+    // Time complexity: O(log N)
+    int black_height(Node *node) const {
+        int height = 0;
+        for (; node != nil; node = node->left) {
+            if (node->color == Color::BLACK) height++;
+        }
+        return height;
+    }
+
+    // Make left and right the children of node, nil is never written
+    void link(Node *node, Node *left, Node *right) {
+        node->left = left;
+        node->right = right;
+        if (left != nil) left->parent = node;
+        if (right != nil) right->parent = node;
+    }
+
+    // Rotations for detached subtrees, the caller links the returned root
+    Node *rotate_left_detached(Node *x) {
+        Node *y = x->right;
+        x->right = y->left;
+        if (y->left != nil) y->left->parent = x;
+        y->left = x;
+        x->parent = y;
+        return y;
+    }
+
+    Node *rotate_right_detached(Node *x) {
+        Node *y = x->left;
+        x->left = y->right;
+        if (y->right != nil) y->right->parent = x;
+        y->right = x;
+        x->parent = y;
+        return y;
+    }
+
+    // Join l < node < r when l is taller: node hangs off the right spine of l at
+    // the first black node as tall as r, red-red violations are rotated away on
+    // the way back up. The returned root may be red with a red right child
+    Node *join_right(Node *l, int l_bh, Node *node, Node *r, int r_bh) {
+        if (l->color == Color::BLACK && l_bh == r_bh) {
+            node->color = Color::RED;
+            link(node, l, r);
+            return node;
+        }
+        Node *child = join_right(l->right, l_bh - (l->color == Color::BLACK ? 1 : 0), node, r, r_bh);
+        l->right = child;
+        child->parent = l;
+        if (l->color == Color::BLACK && child->color == Color::RED && child->right->color == Color::RED) {
+            child->right->color = Color::BLACK;
+            return rotate_left_detached(l);
+        }
+        return l;
+    }
+
+    Node *join_left(Node *l, int l_bh, Node *node, Node *r, int r_bh) {
+        if (r->color == Color::BLACK && r_bh == l_bh) {
+            node->color = Color::RED;
+            link(node, l, r);
+            return node;
+        }
+        Node *child = join_left(l, l_bh, node, r->left, r_bh - (r->color == Color::BLACK ? 1 : 0));
+        r->left = child;
+        child->parent = r;
+        if (r->color == Color::BLACK && child->color == Color::RED && child->left->color == Color::RED) {
+            child->left->color = Color::BLACK;
+            return rotate_right_detached(r);
+        }
+        return r;
+    }
+
+    // Join l < node < r into one subtree, node's old links and color are ignored
+    // Returns the root, its black height goes to bh
+    // Time complexity: O(|bh(l) - bh(r)| + 1)
+    Node *join_subtrees(Node *l, int l_bh, Node *node, Node *r, int r_bh, int &bh) {
+        if (l_bh > r_bh) {
+            Node *t = join_right(l, l_bh, node, r, r_bh);
+            bh = l_bh;
+            if (t->color == Color::RED && t->right->color == Color::RED) {
+                t->color = Color::BLACK;
+                bh++;
+            }
+            return t;
+        }
+        if (r_bh > l_bh) {
+            Node *t = join_left(l, l_bh, node, r, r_bh);
+            bh = r_bh;
+            if (t->color == Color::RED && t->left->color == Color::RED) {
+                t->color = Color::BLACK;
+                bh++;
+            }
+            return t;
+        }
+        link(node, l, r);
+        if (l->color == Color::BLACK && r->color == Color::BLACK) {
+            node->color = Color::RED;
+            bh = l_bh;
+        } else {
+            node->color = Color::BLACK;
+            bh = l_bh + 1;
+        }
+        return node;
+    }
+
+    // Detach the largest node of t into last, returns the rest
+    // Time complexity: O(log N)
+    Node *split_last(Node *t, int t_bh, Node *&last, int &bh) {
+        int child_bh = t_bh - (t->color == Color::BLACK ? 1 : 0);
+        if (t->right == nil) {
+            last = t;
+            bh = child_bh;
+            return t->left;
+        }
+        int right_bh;
+        Node *right = split_last(t->right, child_bh, last, right_bh);
+        return join_subtrees(t->left, child_bh, t, right, right_bh, bh);
+    }
+
+    // Join l < r without a middle node
+    // Time complexity: O(log N)
+    Node *concat_subtrees(Node *l, int l_bh, Node *r, int r_bh, int &bh) {
+        if (l == nil) {
+            bh = r_bh;
+            return r;
+        }
+        Node *last;
+        int rest_bh;
+        Node *rest = split_last(l, l_bh, last, rest_bh);
+        return join_subtrees(rest, rest_bh, last, r, r_bh, bh);
+    }
+
+    // Split t into keys below key (l) and above key (r)
+    // Returns the node holding key, detached, or nil
+    // Time complexity: O(log N)
+    template <typename Q>
+    Node *split_subtree(Node *t, int t_bh, const Q &key, Node *&l, int &l_bh, Node *&r, int &r_bh) {
+        if (t == nil) {
+            l = r = nil;
+            l_bh = r_bh = 0;
+            return nil;
+        }
+        int child_bh = t_bh - (t->color == Color::BLACK ? 1 : 0);
+        Node *t_left = t->left, *t_right = t->right;
+        if (comp(key, t->kv.first)) {
+            Node *part;
+            int part_bh;
+            Node *match = split_subtree(t_left, child_bh, key, l, l_bh, part, part_bh);
+            r = join_subtrees(part, part_bh, t, t_right, child_bh, r_bh);
+            return match;
+        }
+        if (comp(t->kv.first, key)) {
+            Node *part;
+            int part_bh;
+            Node *match = split_subtree(t_right, child_bh, key, part, part_bh, r, r_bh);
+            l = join_subtrees(t_left, child_bh, t, part, part_bh, l_bh);
+            return match;
+        }
+        l = t_left;
+        r = t_right;
+        l_bh = r_bh = child_bh;
+        return t;
+    }
+
+    // Run left() here and hand right() to the shared task pool if parallel is set
+    template <typename Left, typename Right>
+    static void fork_join(bool parallel, Left left, Right right) {
+        if (!parallel) {
+            left();
+            right();
+            return;
+        }
+        TaskPool &pool = TaskPool::shared();
+        TaskPool::Task task;
+        task.run = right;
+        pool.submit(&task);
+        left();
+        pool.wait(&task);
+    }
+
+    // The set operations below return the new root, its black height goes to
+    // bh and the number of nodes they free is added to freed
+    // depth is the number of levels that may still fork
+
+    // Keys in a or b, a's node is kept for keys in both
+    Node *union_subtrees(Node *a, int a_bh, Node *b, int b_bh, int depth, int &bh, size_t &freed) {
+        if (b == nil) {
+            bh = a_bh;
+            return a;
+        }
+        if (a == nil) {
+            bh = b_bh;
+            return b;
+        }
+        int child_bh = a_bh - (a->color == Color::BLACK ? 1 : 0);
+        Node *a_left = a->left, *a_right = a->right;
+        Node *b_left, *b_right;
+        int b_left_bh, b_right_bh;
+        Node *duplicate = split_subtree(b, b_bh, a->kv.first, b_left, b_left_bh, b_right, b_right_bh);
+        if (duplicate != nil) {
+            destroy_node(duplicate);
+            freed++;
+        }
+
+        Node *l, *r;
+        int l_bh, r_bh;
+        size_t right_freed = 0;
+        fork_join(depth > 0 && std::min(a_bh, b_bh) >= PARALLEL_MIN_BLACK_HEIGHT,
+                  [&] { l = union_subtrees(a_left, child_bh, b_left, b_left_bh, depth - 1, l_bh, freed); },
+                  [&] { r = union_subtrees(a_right, child_bh, b_right, b_right_bh, depth - 1, r_bh, right_freed); });
+        freed += right_freed;
+        return join_subtrees(l, l_bh, a, r, r_bh, bh);
+    }
+
+    // Keys in both a and b, a's node is kept
+    Node *intersect_subtrees(Node *a, int a_bh, Node *b, int b_bh, int depth, int &bh, size_t &freed) {
+        if (a == nil || b == nil) {
+            freed += destroy_tree(a) + destroy_tree(b);
+            bh = 0;
+            return nil;
+        }
+        int child_bh = a_bh - (a->color == Color::BLACK ? 1 : 0);
+        Node *a_left = a->left, *a_right = a->right;
+        Node *b_left, *b_right;
+        int b_left_bh, b_right_bh;
+        Node *duplicate = split_subtree(b, b_bh, a->kv.first, b_left, b_left_bh, b_right, b_right_bh);
+
+        Node *l, *r;
+        int l_bh, r_bh;
+        size_t right_freed = 0;
+        fork_join(depth > 0 && std::min(a_bh, b_bh) >= PARALLEL_MIN_BLACK_HEIGHT,
+                  [&] { l = intersect_subtrees(a_left, child_bh, b_left, b_left_bh, depth - 1, l_bh, freed); },
+                  [&] { r = intersect_subtrees(a_right, child_bh, b_right, b_right_bh, depth - 1, r_bh, right_freed); });
+        freed += right_freed + 1;
+        if (duplicate != nil) {
+            destroy_node(duplicate);
+            return join_subtrees(l, l_bh, a, r, r_bh, bh);
+        }
+        destroy_node(a);
+        return concat_subtrees(l, l_bh, r, r_bh, bh);
+    }
+
+    // Keys in a but not in b
+    Node *difference_subtrees(Node *a, int a_bh, Node *b, int b_bh, int depth, int &bh, size_t &freed) {
+        if (a == nil || b == nil) {
+            freed += destroy_tree(b);
+            bh = a_bh;
+            return a;
+        }
+        int child_bh = b_bh - (b->color == Color::BLACK ? 1 : 0);
+        Node *b_left = b->left, *b_right = b->right;
+        Node *a_left, *a_right;
+        int a_left_bh, a_right_bh;
+        Node *duplicate = split_subtree(a, a_bh, b->kv.first, a_left, a_left_bh, a_right, a_right_bh);
+        destroy_node(b);
+        freed++;
+        if (duplicate != nil) {
+            destroy_node(duplicate);
+            freed++;
+        }
+
+        Node *l, *r;
+        int l_bh, r_bh;
+        size_t right_freed = 0;
+        fork_join(depth > 0 && std::min(a_bh, b_bh) >= PARALLEL_MIN_BLACK_HEIGHT,
+                  [&] { l = difference_subtrees(a_left, a_left_bh, b_left, child_bh, depth - 1, l_bh, freed); },
+                  [&] { r = difference_subtrees(a_right, a_right_bh, b_right, child_bh, depth - 1, r_bh, right_freed); });
+        freed += right_freed;
+        return concat_subtrees(l, l_bh, r, r_bh, bh);
+    }
+
+    // Call visit(node) for every node of a detached subtree in order, taking the
+    // subtree apart on the way so visit may free or reuse each node
+    // Left children are rotated up until the current node has none, then it is visited
+    // Time complexity: O(N) with O(1) extra memory
+    template <typename Visit>
+    static void dismantle(Node *node, Visit visit) {
+        while (node != nil) {
+            if (node->left == nil) {
+                Node *right = node->right;
+                visit(node);
+                node = right;
+            } else {
+                Node *left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            }
+        }
+    }
+
+    // Time complexity: O(N) with O(1) extra memory
+    size_t count_nodes(Node *node) const {
+        size_t count = 0;
+        if (node == nil)
+            return count; // maximum() and successor() must not start at the sentinel
+        Node *end = successor(maximum(node));
+        for (Node *current = minimum(node); current != end; current = successor(current))
+            count++;
+        return count;
+    }
+
+    static size_t add_counts(size_t a, size_t b) {
+        return (a == UNKNOWN_COUNT || b == UNKNOWN_COUNT) ? UNKNOWN_COUNT : a + b;
+    }
+
+    // Detach other's nodes and leave it empty, returns its old root
+    // Nodes need no relinking, every tree uses the same sentinel
+    static Node *take_nodes(RBTree &other) {
+        Node *other_root = other.root;
+        other.root = nil;
+        other.set_count(0);
+        other.version++;
+        return other_root;
+    }
+
+    // Insert the nodes of a detached subtree one at a time, reusing them
+    // For a key already present the incoming node replaces the existing one
+    // when incoming_wins is set and is freed otherwise
+    // Time complexity: O(M log N) for M incoming nodes
+    void insert_nodes(Node *incoming, bool incoming_wins) {
+        dismantle(incoming, [&](Node *node) {
+            Node *parent;
+            bool go_left;
+            Node *existing = descend(node->kv.first, parent, go_left);
+            if (existing == nil) {
+                node->left = node->right = nil;
+                node->color = Color::RED;
+                attach(node, parent, go_left);
+            } else if (incoming_wins) {
+                replace_node(existing, node);
+                destroy_node(existing);
+            } else {
+                destroy_node(node);
+            }
+        });
+    }
+
+    // Remove the keys of a detached subtree one at a time and free its nodes
+    // Time complexity: O(M log N) for M removed keys
+    void remove_nodes(Node *removed) {
+        dismantle(removed, [&](Node *node) {
+            Node *parent;
+            bool go_left;
+            remove_node(descend(node->kv.first, parent, go_left));
+            destroy_node(node);
+        });
+    }
+
+    // Whether the set operations should move the nodes of the smaller tree
+    // one at a time: the join-based recursion splits and rejoins the larger
+    // tree around every node of the smaller one, rewriting links and colors on
+    // the way, while an insert or remove mostly reads its path. On one thread
+    // the plain loop is still ahead when the sizes differ 4 times
+    static bool lopsided(size_t small_count, size_t large_count) {
+        return small_count != UNKNOWN_COUNT && large_count != UNKNOWN_COUNT &&
+               small_count * SEQUENTIAL_SIZE_RATIO <= large_count;
+    }
+
+    // Install the result of a join-based operation as the whole tree
+    // An empty result is always counted, whatever count says
+    void set_root(Node *new_root, size_t count) {
+        version++;
+        root = new_root;
+        if (root != nil) {
+            root->parent = nil;
+            root->color = Color::BLACK;
+        }
+        set_count((root == nil) ? 0 : count);
+    }
+
+    // count - freed, or UNKNOWN_COUNT when count is
+    static size_t subtract_count(size_t count, size_t freed) {
+        return count == UNKNOWN_COUNT ? UNKNOWN_COUNT : count - freed;
+    }
+
+    // node_count as it stands, possibly UNKNOWN_COUNT
+    size_t known_count() const {
+        return node_count.load(std::memory_order_relaxed);
+    }
+
+    void set_count(size_t count) const {
+        node_count.store(count, std::memory_order_relaxed);
+    }
+
+    // Fork depth that gives every thread about two tasks
+    static int parallel_depth(int num_threads) {
+        if (num_threads <= 0)
+            num_threads = static_cast<int>(std::thread::hardware_concurrency());
+        int depth = 0;
+        while ((1 << depth) < 2 * num_threads && num_threads > 1) depth++;
+        return depth;
     }
 
 public:
-    RBTree() {
-        nil = new Node(0, Color::BLACK, nullptr); // Sentinel node is always black
-        root = nil;
+    // Bidirectional in-order iterator, it follows the parent links and needs no stack
+    // Stays valid until the node it points to is removed
+    template <bool IsConst>
+    class basic_iterator {
+    private:
+        friend class RBTree;
+        const RBTree *tree;
+        Node *node;
+
+        basic_iterator(const RBTree *tree, Node *node) : tree(tree), node(node) {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef typename RBTree::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<IsConst, const value_type *, value_type *>::type pointer;
+        typedef typename std::conditional<IsConst, const value_type &, value_type &>::type reference;
+
+        basic_iterator() : tree(nullptr), node(nullptr) {}
+
+        // Allow iterator -> const_iterator
+        template <bool OtherConst, typename = typename std::enable_if<IsConst && !OtherConst>::type>
+        basic_iterator(const basic_iterator<OtherConst> &other) : tree(other.tree), node(other.node) {}
+
+        reference operator*() const { return node->kv; }
+        pointer operator->() const { return &node->kv; }
+
+        basic_iterator &operator++() {
+            node = tree->successor(node);
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        // Decrementing end() yields the last element
+        basic_iterator &operator--() {
+            node = (node == tree->nil) ? tree->maximum(tree->root) : tree->predecessor(node);
+            return *this;
+        }
+
+        basic_iterator operator--(int) {
+            basic_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const basic_iterator &other) const { return node == other.node; }
+        bool operator!=(const basic_iterator &other) const { return node != other.node; }
+    };
+
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+
+    explicit RBTree(const Compare &comp = Compare()) : root(nil), node_count(0), comp(comp), version(0) {}
+
+    RBTree(const RBTree &) = delete;
+    RBTree &operator=(const RBTree &) = delete;
+
+    // The moved-from tree is left empty
+    RBTree(RBTree &&other) : root(other.root), node_count(other.known_count()), comp(other.comp), version(0) {
+        copy_counter(counters.rotations, other.counters.rotations);
+        copy_counter(counters.recolors, other.counters.recolors);
+        counters.lookup_shards.store(other.counters.lookup_shards.exchange(nullptr));
+        other.root = nil;
+        other.set_count(0);
+        other.version++;
     }
 
     ~RBTree() {
         destroy_tree(root);
-        delete nil;
+        delete[] counters.lookup_shards.load();
     }
 
-    // Insert a value into the tree (placeholder for implementation)
-    void insert(int data) {
-        // Algorithm to be implemented
+    // Time complexity: O(1), or O(N) once after a split()
+    size_t size() const {
+        size_t count = known_count();
+        if (count == UNKNOWN_COUNT) {
+            count = count_nodes(root);
+            set_count(count);
+        }
+        return count;
     }
 
-    // Delete a value from the tree (placeholder for implementation)
-    void remove(int data) {
-        // Algorithm to be implemented
+    iterator begin() { return iterator(this, minimum(root)); }
+    iterator end() { return iterator(this, nil); }
+    const_iterator begin() const { return const_iterator(this, minimum(root)); }
+    const_iterator end() const { return const_iterator(this, nil); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // Returns an iterator to key, end() if absent
+    // Time complexity: O(log N)
+    iterator find(const K &key) { return iterator(this, lookup(key)); }
+    const_iterator find(const K &key) const { return const_iterator(this, lookup(key)); }
+
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator find(const Q &key) { return iterator(this, lookup(key)); }
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator find(const Q &key) const { return const_iterator(this, lookup(key)); }
+
+    // Returns an iterator to the first key not less than key
+    // Time complexity: O(log N)
+    iterator lower_bound(const K &key) { return iterator(this, lower_bound_node(key)); }
+    const_iterator lower_bound(const K &key) const { return const_iterator(this, lower_bound_node(key)); }
+
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator lower_bound(const Q &key) { return iterator(this, lower_bound_node(key)); }
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator lower_bound(const Q &key) const { return const_iterator(this, lower_bound_node(key)); }
+
+    // Returns an iterator to the first key greater than key
+    // Time complexity: O(log N)
+    iterator upper_bound(const K &key) { return iterator(this, upper_bound_node(key)); }
+    const_iterator upper_bound(const K &key) const { return const_iterator(this, upper_bound_node(key)); }
+
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    iterator upper_bound(const Q &key) { return iterator(this, upper_bound_node(key)); }
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const_iterator upper_bound(const Q &key) const { return const_iterator(this, upper_bound_node(key)); }
+
+    // Call visitor(pair) for every key in [lo, hi) in ascending order
+    // Time complexity: O(log N + k) for k visited keys
+    template <typename Q, typename Visitor>
+    void for_each_in_range(const Q &lo, const Q &hi, Visitor visitor) {
+        for (Node *node = lower_bound_node(lo); node != nil && comp(node->kv.first, hi); node = successor(node))
+            visitor(node->kv);
     }
 
-    // Search for a value in the tree (returns true if found)
-    bool search(int data) const {
-        Node *current = root;
-        while (current != nil) {
-            if (data == current->data) return true;
-            current = (data < current->data) ? current->left : current->right;
+    template <typename Q, typename Visitor>
+    void for_each_in_range(const Q &lo, const Q &hi, Visitor visitor) const {
+        for (Node *node = lower_bound_node(lo); node != nil && comp(node->kv.first, hi); node = successor(node))
+            visitor(static_cast<const value_type &>(node->kv));
+    }
+
+    // Construct a key/value pair in place from args and insert it
+    // The node is built before the key is known, so it is discarded if the key exists
+    // Returns true if the pair was inserted
+    // Time complexity: O(log N)
+    template <typename... Args>
+    bool emplace(Args &&...args) {
+        Node *node = new Node(nil, std::forward<Args>(args)...);
+        Node *parent;
+        bool go_left;
+        if (descend(node->kv.first, parent, go_left) != nil) {
+            destroy_node(node);
+            return false;
         }
-        return false;
+        attach(node, parent, go_left);
+        return true;
     }
 
-    // Destroy the tree (recursive helper)
-    void destroy_tree(Node *node) {
-        if (node == nil) return;
-        destroy_tree(node->left);
-        destroy_tree(node->right);
-        delete node;
+    // Insert key with a value constructed in place from args if key is absent
+    // Nothing is constructed or moved from when the key already exists
+    // Returns true if the pair was inserted
+    // Time complexity: O(log N)
+    template <typename... Args>
+    bool try_emplace(const K &key, Args &&...args) {
+        Node *parent;
+        bool go_left;
+        if (descend(key, parent, go_left) != nil) return false;
+        attach(new Node(nil, std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...)),
+               parent, go_left);
+        return true;
+    }
+
+    template <typename... Args>
+    bool try_emplace(K &&key, Args &&...args) {
+        Node *parent;
+        bool go_left;
+        if (descend(key, parent, go_left) != nil) return false;
+        attach(new Node(nil, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...)),
+               parent, go_left);
+        return true;
+    }
+
+    // Insert a key/value pair into the tree, duplicates are ignored
+    // Time complexity: O(log N)
+    bool insert(const K &key, V value) {
+        return try_emplace(key, std::move(value));
+    }
+
+    // Delete a key from the tree, returns false if it is not present
+    // Time complexity: O(log N)
+    bool remove(const K &key) {
+        return remove_node(lookup(key));
+    }
+
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool remove(const Q &key) {
+        return remove_node(lookup(key));
+    }
+
+    // Remove the element at pos, returns an iterator to the element after it
+    // Time complexity: O(log N)
+    iterator erase(iterator pos) {
+        Node *next = successor(pos.node);
+        remove_node(pos.node); // Only relinks nodes, so next stays valid
+        return iterator(this, next);
+    }
+
+    // Unlink and free z, returns false if z is nil
+    // Time complexity: O(log N)
+    bool remove_node(Node *z) {
+        if (z == nil) return false;
+        version++;
+
+        Node *y = z;
+        Node *x, *x_parent; // x takes y's place, x_parent is tracked because x may be nil
+        Color removed_color = y->color;
+        if (z->left == nil) {
+            x = z->right;
+            x_parent = z->parent;
+            transplant(z, z->right);
+        } else if (z->right == nil) {
+            x = z->left;
+            x_parent = z->parent;
+            transplant(z, z->left);
+        } else {
+            // Replace z with its successor y
+            y = minimum(z->right);
+            removed_color = y->color;
+            x = y->right;
+            if (y->parent == z) {
+                x_parent = y;
+            } else {
+                x_parent = y->parent;
+                transplant(y, y->right);
+                y->right = z->right;
+                y->right->parent = y;
+            }
+            transplant(z, y);
+            y->left = z->left;
+            y->left->parent = y;
+            y->color = z->color;
+        }
+        destroy_node(z);
+        set_count(subtract_count(known_count(), 1));
+        if (removed_color == Color::BLACK)
+            remove_fixup(x, x_parent);
+        return true;
+    }
+
+    // Search for a key in the tree (returns true if found)
+    bool search(const K &key) const {
+        return lookup(key) != nil;
+    }
+
+    // Heterogeneous search, only available with a transparent comparator
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    bool search(const Q &key) const {
+        return lookup(key) != nil;
+    }
+
+    // Returns a pointer to the value stored for key, nullptr if absent
+    V *get(const K &key) {
+        Node *node = lookup(key);
+        return node == nil ? nullptr : &node->kv.second;
+    }
+
+    const V *get(const K &key) const {
+        Node *node = lookup(key);
+        return node == nil ? nullptr : &node->kv.second;
+    }
+
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    V *get(const Q &key) {
+        Node *node = lookup(key);
+        return node == nil ? nullptr : &node->kv.second;
+    }
+
+    template <typename Q, typename C = Compare, typename = typename C::is_transparent>
+    const V *get(const Q &key) const {
+        Node *node = lookup(key);
+        return node == nil ? nullptr : &node->kv.second;
+    }
+
+    // Destroy the tree in O(N) time and O(1) extra memory, returns the number of nodes freed
+    size_t destroy_tree(Node *node) {
+        size_t freed = 0;
+        dismantle(node, [&](Node *current) {
+            destroy_node(current);
+            freed++;
+        });
+        return freed;
+    }
+
+    // Append every key of right, which must all be greater than the keys in this tree
+    // right is left empty
+    // Time complexity: O(log N)
+    void join(RBTree &&right) {
+        assert(root == nil || right.root == nil ||
+               comp(maximum(root)->kv.first, right.minimum(right.root)->kv.first));
+        size_t count = add_counts(known_count(), right.known_count());
+        Node *right_root = take_nodes(right);
+        int bh;
+        set_root(concat_subtrees(root, black_height(root), right_root, black_height(right_root), bh), count);
+    }
+
+    // Move every key not less than key into the returned tree
+    // Both trees count their keys on the next size()
+    // Time complexity: O(log N)
+    RBTree split(const K &key) {
+        RBTree right(comp);
+        Node *l, *r;
+        int l_bh, r_bh;
+        Node *match = split_subtree(root, black_height(root), key, l, l_bh, r, r_bh);
+        if (match != nil) {
+            int bh;
+            r = join_subtrees(nil, 0, match, r, r_bh, bh);
+        }
+        right.set_root(r, UNKNOWN_COUNT);
+        set_root(l, UNKNOWN_COUNT);
+        return right;
+    }
+
+    // Set operations that consume other and leave the result in this tree
+    // For keys in both trees the pair in this tree is kept
+    // The root of one tree splits the other, the two halves recurse independently
+    // and are joined back around the root; the top levels are handed to the
+    // shared task pool as tasks for up to num_threads threads (0 means one per
+    // hardware thread). When one tree is SEQUENTIAL_SIZE_RATIO times smaller its
+    // nodes are inserted or removed one at a time instead
+    // Work: O(M log(N / M + 1)) for M <= N
+    void set_union(RBTree &&other, int num_threads = 0) {
+        if (lopsided(known_count(), other.known_count())) {
+            // Keep the larger tree in place; the pairs of this tree still win
+            version++;
+            std::swap(root, other.root);
+            size_t other_count = other.known_count();
+            other.set_count(known_count());
+            set_count(other_count);
+            insert_nodes(take_nodes(other), true);
+            return;
+        }
+        if (lopsided(other.known_count(), known_count())) {
+            insert_nodes(take_nodes(other), false);
+            return;
+        }
+        size_t count = add_counts(known_count(), other.known_count());
+        Node *other_root = take_nodes(other);
+        int bh;
+        size_t freed = 0;
+        Node *result = union_subtrees(root, black_height(root), other_root, black_height(other_root),
+                                      parallel_depth(num_threads), bh, freed);
+        set_root(result, subtract_count(count, freed));
+    }
+
+    void set_intersection(RBTree &&other, int num_threads = 0) {
+        size_t count = add_counts(known_count(), other.known_count());
+        Node *other_root = take_nodes(other);
+        int bh;
+        size_t freed = 0;
+        Node *result = intersect_subtrees(root, black_height(root), other_root, black_height(other_root),
+                                          parallel_depth(num_threads), bh, freed);
+        set_root(result, subtract_count(count, freed));
+    }
+
+    void set_difference(RBTree &&other, int num_threads = 0) {
+        if (lopsided(other.known_count(), known_count())) {
+            remove_nodes(take_nodes(other));
+            return;
+        }
+        size_t count = add_counts(known_count(), other.known_count());
+        Node *other_root = take_nodes(other);
+        int bh;
+        size_t freed = 0;
+        Node *result = difference_subtrees(root, black_height(root), other_root, black_height(other_root),
+                                           parallel_depth(num_threads), bh, freed);
+        set_root(result, subtract_count(count, freed));
+    }
+
+    // Progress of a shape walk spread over several stats_step() calls
+    // A walk started on one tree restarts when used on another one or when
+    // the tree was modified since the last call
+    class ShapeWalk {
+    public:
+        ShapeWalk() : tree(nullptr), version(0), node(nullptr), prev(nullptr), depth(0), depth_sum(0), visited(0) {}
+
+    private:
+        friend class RBTree;
+        const RBTree *tree;
+        uint64_t version;
+        Node *node;
+        Node *prev;
+        int depth;
+        uint64_t depth_sum;
+        uint64_t visited;
+        std::vector<uint64_t> depth_histogram;
+    };
+
+    // Memory use, shape and event counters
+    // The counters and memory figures cost O(log N); the shape needs a walk over
+    // every node, so writers wait O(N) unless include_shape is false or the
+    // walk is spread over stats_step() calls. The walk follows parent links
+    // and needs O(1) extra memory besides the histogram
+    RBTreeStats stats(bool include_shape = true) const {
+        if (!include_shape)
+            return counter_stats();
+        ShapeWalk walk;
+        RBTreeStats result = {};
+        stats_step(walk, SIZE_MAX, result);
+        return result;
+    }
+
+    // Continue walk for at most budget nodes. Returns true and fills in result,
+    // shape included, once every node has been visited; a finished walk stays
+    // valid, and later calls are O(log N), until the tree changes. A tree that
+    // changes between every call never finishes, give it a bigger budget
+    // Time complexity: O(budget + log N) per call
+    bool stats_step(ShapeWalk &walk, size_t budget, RBTreeStats &result) const {
+        if (walk.tree != this || walk.version != version) {
+            walk = ShapeWalk();
+            walk.tree = this;
+            walk.version = version;
+            walk.node = root;
+            walk.prev = nil;
+        }
+        Node *node = walk.node;
+        Node *prev = walk.prev;
+        int depth = walk.depth;
+        while (node != nil) {
+            Node *next;
+            if (prev == node->parent) {
+                // First visit, coming down from the parent
+                if (budget == 0)
+                    break;
+                budget--;
+                if (static_cast<size_t>(depth) >= walk.depth_histogram.size())
+                    walk.depth_histogram.resize(depth + 1, 0);
+                walk.depth_histogram[depth]++;
+                walk.depth_sum += depth;
+                walk.visited++;
+                next = (node->left != nil) ? node->left : (node->right != nil) ? node->right : node->parent;
+            } else if (prev == node->left && node->right != nil) {
+                next = node->right;
+            } else {
+                next = node->parent;
+            }
+            depth += (next == node->parent) ? -1 : 1;
+            prev = node;
+            node = next;
+        }
+        walk.node = node;
+        walk.prev = prev;
+        walk.depth = depth;
+        if (node != nil)
+            return false;
+
+        // The walk counted the nodes, so a split() leaves nothing to count here
+        if (known_count() == UNKNOWN_COUNT)
+            set_count(walk.visited);
+        result = counter_stats();
+        result.has_shape = true;
+        result.depth_histogram = walk.depth_histogram;
+        result.max_depth = walk.depth_histogram.empty() ? 0 : static_cast<int>(walk.depth_histogram.size()) - 1;
+        result.average_depth = walk.visited ? static_cast<double>(walk.depth_sum) / walk.visited : 0.0;
+        return true;
+    }
+
+    void reset_counters() {
+        counters.rotations.store(0, std::memory_order_relaxed);
+        counters.recolors.store(0, std::memory_order_relaxed);
+        delete[] counters.lookup_shards.exchange(nullptr);
     }
 
     // Validate all red-black tree properties
@@ -122,11 +1600,228 @@ public:
         inorder_traversal(root);
         std::cout << std::endl;
     }
+
+    // Write the tree to path in the mmap-able on-disk format, returns false on I/O error
+    // Only trees with trivial key and value types can be saved
+    // The file is written to a uniquely named file next to path, synced and renamed
+    // over it, and the directory is synced after the rename, so neither readers, a
+    // crash nor a concurrent save() of the same path ever see a partial file
+    // Time complexity: O(N)
+    bool save(const char *path) const {
+        static_assert(std::is_trivial<K>::value && std::is_trivial<V>::value,
+                      "save() copies keys and values byte for byte");
+        typedef RBDiskNode<K, V> DiskNode;
+        std::vector<DiskNode> records;
+        // Pre-order walk with an explicit stack; each entry remembers which
+        // record links to it so the relative offset can be patched on visit
+        struct Pending {
+            Node *node;
+            size_t parent_idx;
+            bool is_left;
+        };
+        std::vector<Pending> stack;
+        if (root != nil)
+            stack.push_back({root, 0, false});
+        while (!stack.empty()) {
+            Pending cur = stack.back();
+            stack.pop_back();
+
+            size_t idx = records.size();
+            DiskNode record;
+            std::memset(&record, 0, sizeof(record)); // Zero padding so the checksum is deterministic
+            record.key = cur.node->kv.first;
+            record.value = cur.node->kv.second;
+            record.color = static_cast<uint32_t>(cur.node->color);
+            records.push_back(record);
+            if (idx != 0) {
+                int64_t offset = static_cast<int64_t>((idx - cur.parent_idx) * sizeof(DiskNode));
+                if (cur.is_left)
+                    records[cur.parent_idx].left = offset;
+                else
+                    records[cur.parent_idx].right = offset;
+            }
+
+            if (cur.node->right != nil)
+                stack.push_back({cur.node->right, idx, false});
+            if (cur.node->left != nil)
+                stack.push_back({cur.node->left, idx, true});
+        }
+
+        RBFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, RB_FILE_MAGIC, sizeof(header.magic));
+        header.version = RB_FILE_VERSION;
+        header.node_size = sizeof(DiskNode);
+        header.key_size = sizeof(K);
+        header.value_size = sizeof(V);
+        header.node_count = records.size();
+        header.root_offset = records.empty() ? 0 : sizeof(RBFileHeader);
+        header.payload_checksum = fnv1a_64(records.data(), records.size() * sizeof(DiskNode));
+        header.header_checksum = fnv1a_64(&header, offsetof(RBFileHeader, header_checksum));
+
+        // mkstemp() picks a name no other save() is using and creates it 0600
+        std::string tmp_path = std::string(path) + ".tmp.XXXXXX";
+        int fd = mkstemp(&tmp_path[0]);
+        if (fd < 0) return false;
+        FILE *fp = (fchmod(fd, 0644) == 0) ? fdopen(fd, "wb") : nullptr;
+        if (!fp) {
+            ::close(fd);
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, fp) == 1;
+        if (ok && !records.empty())
+            ok = std::fwrite(records.data(), sizeof(DiskNode), records.size(), fp) == records.size();
+        // The data must be on disk before the rename can replace the last good file
+        ok = ok && std::fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+        ok = (std::fclose(fp) == 0) && ok;
+        if (!ok || std::rename(tmp_path.c_str(), path) != 0) {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        // Make the rename itself durable
+        const char *slash = std::strrchr(path, '/');
+        std::string dir = slash ? std::string(path, slash == path ? 1 : slash - path) : std::string(".");
+        int dir_fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dir_fd < 0) return false;
+        ok = fsync(dir_fd) == 0;
+        ::close(dir_fd);
+        return ok;
+    }
+};
+
+// Read-only red-black tree served directly from a file written by RBTree::save()
+// open() only validates the header, so startup cost does not depend on the tree
+// size and search() faults in just the pages on the root-to-leaf path
+// K, V and Compare must match the RBTree that wrote the file
+template <typename K, typename V, typename Compare = std::less<K>>
+class MappedRBTree {
+private:
+    typedef RBDiskNode<K, V> DiskNode;
+    static_assert(sizeof(RBFileHeader) % alignof(DiskNode) == 0, "records must stay aligned");
+
+    const unsigned char *base;
+    size_t length;
+    Compare comp;
+
+    const RBFileHeader *header() const {
+        return reinterpret_cast<const RBFileHeader *>(base);
+    }
+
+    // Returns the record at byte offset pos or nullptr if pos is out of range
+    const DiskNode *record_at(uint64_t pos) const {
+        if (pos < sizeof(RBFileHeader) || pos > length - sizeof(DiskNode))
+            return nullptr;
+        if ((pos - sizeof(RBFileHeader)) % sizeof(DiskNode) != 0)
+            return nullptr;
+        return reinterpret_cast<const DiskNode *>(base + pos);
+    }
+
+    // Returns the record holding key or nullptr
+    // Links are bounds-checked, so a corrupted file yields nullptr instead of a crash
+    const DiskNode *lookup(const K &key) const {
+        if (!base || header()->node_count == 0) return nullptr;
+        uint64_t pos = header()->root_offset;
+        // A valid tree is never deeper than its node count, this also stops cycles
+        for (uint64_t steps = 0; steps < header()->node_count; steps++) {
+            const DiskNode *node = record_at(pos);
+            if (!node) return nullptr;
+            int64_t link;
+            if (comp(key, node->key))
+                link = node->left;
+            else if (comp(node->key, key))
+                link = node->right;
+            else
+                return node;
+            if (link == 0) return nullptr;
+            pos += link;
+        }
+        return nullptr;
+    }
+
+public:
+    explicit MappedRBTree(const Compare &comp = Compare()) : base(nullptr), length(0), comp(comp) {}
+    MappedRBTree(const MappedRBTree &) = delete;
+    MappedRBTree &operator=(const MappedRBTree &) = delete;
+
+    ~MappedRBTree() {
+        close();
+    }
+
+    // Map the file at path and validate its header, returns false if the
+    // file is missing, truncated, from another version or has a bad header
+    bool open(const char *path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RBFileHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file alive
+        if (addr == MAP_FAILED) return false;
+        // Lookups jump around the file, so read-ahead would only waste I/O
+        madvise(addr, st.st_size, MADV_RANDOM);
+
+        base = static_cast<const unsigned char *>(addr);
+        length = st.st_size;
+
+        const RBFileHeader *h = header();
+        bool valid = std::memcmp(h->magic, RB_FILE_MAGIC, sizeof(h->magic)) == 0 &&
+                     h->version == RB_FILE_VERSION &&
+                     h->node_size == sizeof(DiskNode) &&
+                     h->key_size == sizeof(K) &&
+                     h->value_size == sizeof(V) &&
+                     h->header_checksum == fnv1a_64(h, offsetof(RBFileHeader, header_checksum)) &&
+                     h->node_count <= (length - sizeof(RBFileHeader)) / sizeof(DiskNode) &&
+                     length == sizeof(RBFileHeader) + h->node_count * sizeof(DiskNode) &&
+                     (h->node_count == 0 ? h->root_offset == 0 : record_at(h->root_offset) != nullptr);
+        if (!valid) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (base)
+            munmap(const_cast<unsigned char *>(base), length);
+        base = nullptr;
+        length = 0;
+    }
+
+    // Check the payload checksum, this touches every page of the file
+    // Time complexity: O(N)
+    bool verify_checksum() const {
+        if (!base) return false;
+        return header()->payload_checksum ==
+               fnv1a_64(base + sizeof(RBFileHeader), length - sizeof(RBFileHeader));
+    }
+
+    uint64_t size() const {
+        return base ? header()->node_count : 0;
+    }
+
+    // Search for a key in the mapped tree (returns true if found)
+    // Time complexity: O(log N)
+    bool search(const K &key) const {
+        return lookup(key) != nullptr;
+    }
+
+    // Returns a pointer into the mapping for the value stored for key, nullptr if absent
+    // Time complexity: O(log N)
+    const V *get(const K &key) const {
+        const DiskNode *node = lookup(key);
+        return node ? &node->value : nullptr;
+    }
 };
 
 // Test framework for the red-black tree
 void test_rb_tree() {
-    RBTree tree;
+    RBTree<int, int> tree;
 
     const int num_runs = 100;
     const int large_test_size = 10000;
@@ -135,7 +1830,7 @@ void test_rb_tree() {
     std::cout << "Small Random Test:\n";
     std::vector<int> small_test = {10, 20, 15, 5, 25, 30};
     for (int num : small_test) {
-        tree.insert(num);
+        tree.insert(num, num);
     }
     tree.validate_rb_properties();
     for (int num : small_test) {
@@ -153,12 +1848,12 @@ void test_rb_tree() {
     double total_time = 0.0;
 
     for (int run = 0; run < num_runs; run++) {
-        RBTree test_tree;
+        RBTree<int, int> test_tree;
 
         // Measure insertion time
         auto start_time = std::chrono::high_resolution_clock::now();
         for (int num : large_test) {
-            test_tree.insert(num);
+            test_tree.insert(num, num);
         }
         auto end_time = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> elapsed_time = end_time - start_time;
@@ -177,11 +1872,701 @@ void test_rb_tree() {
     double average_time = total_time / num_runs;
     std::cout << "Average time to insert large array over " << num_runs << " runs: " 
               << average_time << " seconds\n";
+
+    // Remove test
+    std::cout << "\nRemove Test:\n";
+    {
+        RBTree<int, int> test_tree;
+        for (int num : large_test) {
+            test_tree.insert(num, num);
+        }
+        // Remove every other element and check the rest survive
+        std::vector<int> removed;
+        for (size_t i = 0; i < large_test.size(); i += 2) {
+            test_tree.remove(large_test[i]);
+            removed.push_back(large_test[i]);
+        }
+        std::sort(removed.begin(), removed.end());
+        test_tree.validate_rb_properties();
+        for (int num : large_test) {
+            bool was_removed = std::binary_search(removed.begin(), removed.end(), num);
+            assert(test_tree.search(num) == !was_removed);
+        }
+        for (int num : large_test) {
+            test_tree.remove(num);
+        }
+        test_tree.validate_rb_properties();
+        assert(!test_tree.search(large_test[0]));
+    }
+}
+
+// Test framework for the mmap-able on-disk format
+void test_mapped_rb_tree() {
+    const char *path = "rb_tree_test.bin";
+    const int large_test_size = 1000000;
+
+    std::cout << "\nMapped File Test:\n";
+    std::vector<int> large_test(large_test_size);
+    for (int &num : large_test) {
+        num = std::rand();
+    }
+
+    RBTree<int, int> tree;
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (int num : large_test) {
+        tree.insert(num, num);
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> rebuild_time = end_time - start_time;
+    bool saved = tree.save(path);
+    assert(saved);
+
+    MappedRBTree<int, int> mapped;
+    start_time = std::chrono::high_resolution_clock::now();
+    bool opened = mapped.open(path);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> open_time = end_time - start_time;
+    assert(opened);
+
+    assert(mapped.verify_checksum());
+    for (int num : large_test) {
+        assert(mapped.search(num));
+        assert(*mapped.get(num) == num);
+    }
+    for (int i = 0; i < 1000; i++) {
+        int num = std::rand();
+        assert(mapped.search(num) == tree.search(num));
+    }
+    std::cout << "Rebuild by insertion: " << rebuild_time.count() << " seconds, open mapped file: "
+              << open_time.count() << " seconds\n";
+    mapped.close();
+
+    // A flipped payload byte is caught by the checksum
+    FILE *fp = std::fopen(path, "r+b");
+    assert(fp);
+    typedef RBDiskNode<int, int> DiskNode;
+    std::fseek(fp, sizeof(RBFileHeader) + offsetof(DiskNode, key), SEEK_SET);
+    int corrupted = large_test[0] ^ 1;
+    std::fwrite(&corrupted, sizeof(corrupted), 1, fp);
+    std::fclose(fp);
+    opened = mapped.open(path);
+    assert(opened);
+    assert(!mapped.verify_checksum());
+    mapped.close();
+
+    // Other versions are rejected up front
+    fp = std::fopen(path, "r+b");
+    assert(fp);
+    std::fseek(fp, offsetof(RBFileHeader, version), SEEK_SET);
+    uint32_t version = RB_FILE_VERSION + 1;
+    std::fwrite(&version, sizeof(version), 1, fp);
+    std::fclose(fp);
+    opened = mapped.open(path);
+    assert(!opened);
+
+    // Concurrent saves of one path write separate temp files, so whichever
+    // rename comes last leaves one whole tree behind
+    RBTree<int, int> evens, odds;
+    for (int num = 0; num < 20000; num += 2) {
+        evens.insert(num, num);
+        odds.insert(num + 1, num + 1);
+    }
+    for (int round = 0; round < 20; round++) {
+        bool saved_evens = false;
+        std::thread writer([&] { saved_evens = evens.save(path); });
+        bool saved_odds = odds.save(path);
+        writer.join();
+        assert(saved_evens && saved_odds);
+        opened = mapped.open(path);
+        assert(opened);
+        assert(mapped.verify_checksum() && mapped.size() == 10000);
+        assert(mapped.search(0) != mapped.search(1));
+        mapped.close();
+    }
+
+    // Empty trees round-trip as well
+    RBTree<int, int> empty;
+    saved = empty.save(path);
+    assert(saved);
+    opened = mapped.open(path);
+    assert(opened);
+    assert(mapped.size() == 0 && !mapped.search(42));
+    mapped.close();
+    std::remove(path);
+}
+
+// Test framework for iterators and range scans
+void test_rb_tree_iterators() {
+    const int large_test_size = 100000;
+
+    std::cout << "\nIterator Test:\n";
+    RBTree<int, int> tree;
+    std::vector<int> keys(large_test_size);
+    for (int &num : keys) {
+        num = std::rand() % (large_test_size * 4);
+        tree.insert(num, -num);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    assert(tree.size() == keys.size());
+
+    // Forward and backward iteration
+    size_t i = 0;
+    for (const auto &kv : tree) {
+        assert(kv.first == keys[i] && kv.second == -keys[i]);
+        i++;
+    }
+    assert(i == keys.size());
+    auto it = tree.end();
+    for (size_t j = keys.size(); j-- > 0;) {
+        --it;
+        assert(it->first == keys[j]);
+    }
+    assert(it == tree.begin());
+
+    // Bounds agree with the standard library on a sorted vector
+    for (int run = 0; run < 1000; run++) {
+        int probe = std::rand() % (large_test_size * 4 + 2) - 1;
+        auto lower = std::lower_bound(keys.begin(), keys.end(), probe);
+        auto upper = std::upper_bound(keys.begin(), keys.end(), probe);
+        assert((tree.lower_bound(probe) == tree.end()) == (lower == keys.end()));
+        assert(lower == keys.end() || tree.lower_bound(probe)->first == *lower);
+        assert((tree.upper_bound(probe) == tree.end()) == (upper == keys.end()));
+        assert(upper == keys.end() || tree.upper_bound(probe)->first == *upper);
+    }
+
+    // Range scans visit exactly [lo, hi)
+    for (int run = 0; run < 100; run++) {
+        int lo = std::rand() % (large_test_size * 4);
+        int hi = lo + std::rand() % 1000;
+        std::vector<int> visited;
+        tree.for_each_in_range(lo, hi, [&](const std::pair<const int, int> &kv) { visited.push_back(kv.first); });
+        std::vector<int> expected(std::lower_bound(keys.begin(), keys.end(), lo),
+                                  std::lower_bound(keys.begin(), keys.end(), hi));
+        assert(visited == expected);
+    }
+
+    // Values are writable through iterators, erase returns the next element
+    tree.find(keys[0])->second = 42;
+    assert(*tree.get(keys[0]) == 42);
+    it = tree.begin();
+    while (it != tree.end()) {
+        it = (it->first % 2 == 0) ? tree.erase(it) : std::next(it);
+    }
+    tree.validate_rb_properties();
+    for (const auto &kv : tree) {
+        assert(kv.first % 2 != 0);
+    }
+
+    // Sequential keys build the deepest trees the insert path produces
+    RBTree<int, int> sequential;
+    for (int num = 0; num < 1000000; num++) {
+        sequential.insert(num, num);
+    }
+    sequential.validate_rb_properties();
+    int expected_key = 0;
+    for (auto kv = sequential.cbegin(); kv != sequential.cend(); ++kv) {
+        assert(kv->first == expected_key++);
+    }
+}
+
+// Test framework for join, split and the set operations
+void test_rb_tree_set_operations() {
+    std::cout << "\nSet Operation Test:\n";
+    auto make_tree = [](const std::vector<int> &keys, int value) {
+        RBTree<int, int> tree;
+        for (int key : keys) tree.insert(key, value);
+        return tree;
+    };
+    auto check = [](const RBTree<int, int> &tree, const std::map<int, int> &expected) {
+        tree.validate_rb_properties();
+        assert(tree.size() == expected.size());
+        assert(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+    };
+    auto random_keys = [](int size, int range) {
+        std::vector<int> keys(size);
+        for (int &num : keys) num = std::rand() % range;
+        return keys;
+    };
+
+    // Sizes cover empty trees, very different heights and equal heights
+    const int sizes[][2] = {{0, 0}, {0, 100}, {100, 0}, {1, 1000}, {100000, 10}, {1000, 100000}, {100000, 100000}};
+    for (const auto &size : sizes) {
+        for (int num_threads : {1, 4}) {
+            std::vector<int> a_keys = random_keys(size[0], 4 * std::max(size[0], size[1]) + 1);
+            std::vector<int> b_keys = random_keys(size[1], 4 * std::max(size[0], size[1]) + 1);
+            std::map<int, int> a_map, b_map;
+            for (int key : a_keys) a_map[key] = 1;
+            for (int key : b_keys) b_map[key] = 2;
+
+            std::map<int, int> expected_union = b_map, expected_intersection, expected_difference;
+            for (const auto &kv : a_map) {
+                expected_union[kv.first] = 1; // Values from this tree win
+                if (b_map.count(kv.first))
+                    expected_intersection.insert(kv);
+                else
+                    expected_difference.insert(kv);
+            }
+
+            RBTree<int, int> united = make_tree(a_keys, 1);
+            RBTree<int, int> other = make_tree(b_keys, 2);
+            united.set_union(std::move(other), num_threads);
+            assert(other.size() == 0 && other.begin() == other.end());
+            check(united, expected_union);
+
+            RBTree<int, int> intersected = make_tree(a_keys, 1);
+            intersected.set_intersection(make_tree(b_keys, 2), num_threads);
+            check(intersected, expected_intersection);
+
+            RBTree<int, int> subtracted = make_tree(a_keys, 1);
+            subtracted.set_difference(make_tree(b_keys, 2), num_threads);
+            check(subtracted, expected_difference);
+
+            // The results are ordinary trees afterwards
+            bool united_inserted = united.insert(-1, 0);
+            bool subtracted_inserted = subtracted.insert(-1, 0);
+            assert(united_inserted && subtracted_inserted);
+            if (!expected_difference.empty()) {
+                bool removed = subtracted.remove(expected_difference.begin()->first);
+                assert(removed);
+            }
+            united.validate_rb_properties();
+            subtracted.validate_rb_properties();
+        }
+    }
+
+    // Split at random keys, then join the halves back
+    std::vector<int> keys = random_keys(100000, 400000);
+    std::map<int, int> expected;
+    for (int key : keys) expected[key] = 0;
+    RBTree<int, int> tree = make_tree(keys, 0);
+    for (int run = 0; run < 100; run++) {
+        int pivot = std::rand() % 400002 - 1;
+        RBTree<int, int> right = tree.split(pivot);
+        tree.validate_rb_properties();
+        right.validate_rb_properties();
+        assert(tree.size() == static_cast<size_t>(std::distance(expected.begin(), expected.lower_bound(pivot))));
+        assert(tree.size() + right.size() == expected.size());
+        assert(tree.begin() == tree.end() || (--tree.end())->first < pivot);
+        assert(right.begin() == right.end() || right.begin()->first >= pivot);
+        tree.join(std::move(right));
+        assert(right.size() == 0);
+        check(tree, expected);
+    }
+
+    // Splits below the smallest and above the largest key leave one side empty
+    for (int pivot : {expected.begin()->first, -1, 400001}) {
+        RBTree<int, int> right = tree.split(pivot);
+        RBTree<int, int> &empty = (pivot == 400001) ? right : tree;
+        RBTree<int, int> &full = (pivot == 400001) ? tree : right;
+        assert(empty.size() == 0 && empty.begin() == empty.end());
+        RBTreeStats empty_stats = empty.stats(false);
+        assert(empty_stats.node_count == 0 && empty_stats.black_height == 0);
+        empty_stats = empty.stats();
+        assert(empty_stats.node_count == 0 && empty_stats.depth_histogram.empty());
+        assert(full.size() == expected.size());
+        assert(full.stats().node_count == expected.size());
+        check(full, expected);
+        tree.join(std::move(right));
+        check(tree, expected);
+    }
+}
+
+// Test framework for the stats API
+void test_rb_tree_stats() {
+    std::cout << "\nStats Test:\n";
+    // Lookup counters are allocated on the first lookup, so trees stay small
+    static_assert(sizeof(RBTree<int, int>) <= 128, "lookup shards must not live in the tree");
+    RBTree<int, int> tree;
+    RBTreeStats empty = tree.stats();
+    assert(empty.node_count == 0 && empty.max_depth == 0 && empty.depth_histogram.empty());
+    assert(empty.black_height == 0 && empty.rotations == 0 && empty.lookups == 0);
+
+    // Sequential keys make the insert path rotate and recolor all the time
+    const int size = 100000;
+    for (int num = 0; num < size; num++) {
+        tree.insert(num, num);
+    }
+    RBTreeStats stats = tree.stats();
+    assert(stats.node_count == static_cast<uint64_t>(size));
+    assert(stats.bytes_allocated == size * stats.node_bytes);
+    assert(stats.bytes_per_key > stats.payload_bytes);
+    uint64_t histogram_total = 0;
+    for (uint64_t count : stats.depth_histogram) histogram_total += count;
+    assert(histogram_total == static_cast<uint64_t>(size));
+    assert(stats.depth_histogram[0] == 1);
+    assert(stats.average_depth <= stats.max_depth);
+    // The longest path is at most twice the black height
+    assert(stats.max_depth + 1 <= 2 * stats.black_height);
+    assert(stats.rotations > 0 && stats.recolors > 0);
+    assert(stats.lookups == 0); // insert descends without lookup()
+
+    // Lookups are counted along with the nodes they visit
+    for (int num = 0; num < 1000; num++) {
+        bool found = tree.search(std::rand() % size);
+        assert(found);
+    }
+    bool found = tree.search(-1);
+    assert(!found);
+    stats = tree.stats(false);
+    assert(!stats.has_shape && stats.depth_histogram.empty());
+    assert(stats.lookups == 1001);
+    assert(stats.max_lookup_path <= static_cast<uint64_t>(2 * stats.black_height));
+    assert(stats.average_lookup_path >= 1.0 && stats.average_lookup_path <= stats.max_lookup_path);
+
+    // remove rebalances too
+    uint64_t rotations = stats.rotations, recolors = stats.recolors;
+    for (int num = 0; num < size; num += 2) {
+        bool removed = tree.remove(num);
+        assert(removed);
+    }
+    stats = tree.stats();
+    assert(stats.rotations > rotations && stats.recolors > recolors);
+    assert(stats.node_count == static_cast<uint64_t>(size / 2));
+
+    std::string json = stats.to_json();
+    assert(json.front() == '{' && json.back() == '}');
+    assert(json.find("\"node_count\":50000") != std::string::npos);
+    assert(json.find("\"depth_histogram\":[1,2,") != std::string::npos);
+    std::cout << json << std::endl;
+
+    // Readers on other threads count into their own shards; with fewer threads
+    // than shards none is shared and no increment is lost
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&tree] {
+            for (int num = 1; num < 2000; num += 2) {
+                bool found = tree.search(num);
+                assert(found);
+            }
+        });
+    }
+    for (std::thread &reader : readers) reader.join();
+    RBTreeStats after_readers = tree.stats(false);
+    assert(after_readers.lookups == stats.lookups + 4 * 1000);
+    assert(after_readers.max_lookup_path >= stats.max_lookup_path);
+
+    // A walk spread over many small steps gives the same shape as one full walk
+    RBTree<int, int>::ShapeWalk walk;
+    RBTreeStats stepped = {};
+    int steps = 1;
+    while (!tree.stats_step(walk, 1000, stepped)) steps++;
+    assert(steps == size / 2 / 1000);
+    assert(stepped.depth_histogram == stats.depth_histogram && stepped.average_depth == stats.average_depth);
+    bool finished = tree.stats_step(walk, 0, stepped);
+    assert(finished); // A finished walk stays valid
+
+    // A change in the middle of a walk restarts it
+    walk = RBTree<int, int>::ShapeWalk();
+    finished = tree.stats_step(walk, 1000, stepped);
+    assert(!finished);
+    bool inserted = tree.insert(0, 0);
+    assert(inserted);
+    while (!tree.stats_step(walk, 1000, stepped)) {}
+    assert(stepped.node_count == static_cast<uint64_t>(size / 2 + 1));
+    uint64_t walked = 0;
+    for (uint64_t count : stepped.depth_histogram) walked += count;
+    assert(walked == stepped.node_count);
+
+    // The walk also counts the keys a split() moved
+    RBTree<int, int> right = tree.split(size / 2);
+    walk = RBTree<int, int>::ShapeWalk();
+    while (!right.stats_step(walk, 1000, stepped)) {}
+    assert(stepped.node_count == static_cast<uint64_t>(size / 4));
+    assert(right.size() == static_cast<size_t>(size / 4));
+
+    // Any of several readers may be the one to count a split tree
+    RBTree<int, int> upper = right.split(size * 3 / 4);
+    std::vector<size_t> counted(4);
+    readers.clear();
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&upper, &counted, t] {
+            counted[t] = (t % 2) ? upper.size() : upper.stats().node_count;
+        });
+    }
+    for (std::thread &reader : readers) reader.join();
+    for (size_t count : counted) assert(count == static_cast<size_t>(size / 8));
+
+    tree.reset_counters();
+    stats = tree.stats(false);
+    assert(stats.rotations == 0 && stats.recolors == 0 && stats.lookups == 0 && stats.max_lookup_path == 0);
+    found = tree.search(1);
+    assert(found);
+    assert(tree.stats(false).lookups == 1);
+
+    // Counters move along with the nodes
+    RBTree<int, int> moved(std::move(tree));
+    assert(moved.stats(false).lookups == 1 && tree.stats(false).lookups == 0);
+}
+
+// Counts constructions so tests can check that nothing is built or copied needlessly
+struct Tracked {
+    static int constructed;
+    static int copied;
+    static int moved;
+    int a, b;
+
+    Tracked(int a, int b) : a(a), b(b) { constructed++; }
+    Tracked(const Tracked &other) : a(other.a), b(other.b) { copied++; }
+    Tracked(Tracked &&other) : a(other.a), b(other.b) { moved++; }
+};
+int Tracked::constructed = 0;
+int Tracked::copied = 0;
+int Tracked::moved = 0;
+
+// Test framework for the key/value interface
+void test_rb_tree_map() {
+    std::cout << "\nMap Test:\n";
+
+    // Values are constructed in place, and not at all for existing keys
+    RBTree<int, Tracked> tracked;
+    bool inserted = tracked.try_emplace(1, 10, 20);
+    assert(inserted);
+    inserted = tracked.try_emplace(1, 30, 40);
+    assert(!inserted);
+    inserted = tracked.emplace(std::piecewise_construct, std::forward_as_tuple(2), std::forward_as_tuple(50, 60));
+    assert(inserted);
+    assert(Tracked::constructed == 2 && Tracked::copied == 0 && Tracked::moved == 0);
+    assert(tracked.get(1)->a == 10 && tracked.get(2)->b == 60);
+
+    // Move-only values
+    RBTree<int, std::unique_ptr<int>> owners;
+    for (int i = 0; i < 1000; i++) {
+        inserted = owners.try_emplace(i, new int(i * 2));
+        assert(inserted);
+    }
+    inserted = owners.insert(1000, std::make_unique<int>(2000));
+    assert(inserted);
+    inserted = owners.insert(1000, std::make_unique<int>(0));
+    assert(!inserted);
+    for (int i = 0; i < 1000; i += 3) {
+        bool removed = owners.remove(i);
+        assert(removed);
+    }
+    owners.validate_rb_properties();
+    for (int i = 0; i <= 1000; i++) {
+        std::unique_ptr<int> *value = owners.get(i);
+        assert((value != nullptr) == (i % 3 != 0 || i == 1000));
+        assert(!value || **value == i * 2);
+    }
+
+    // Heterogeneous lookups with a transparent comparator
+    RBTree<std::string, int, std::less<>> names;
+    const char *words[] = {"delta", "alpha", "echo", "charlie", "bravo"};
+    for (int i = 0; i < 5; i++) {
+        inserted = names.insert(words[i], i);
+        assert(inserted);
+    }
+    names.validate_rb_properties();
+    std::string_view probe = "charlie";
+    assert(names.search(probe) && *names.get(probe) == 3);
+    assert(!names.search(std::string_view("foxtrot")));
+    assert(names.search("echo"));
+    bool removed = names.remove(std::string_view("alpha"));
+    assert(removed && !names.search("alpha"));
+    assert(names.size() == 4);
+}
+
+// Compare insertion and lookup throughput against std::map
+void benchmark_rb_tree_vs_std_map() {
+    const int bench_size = 200000;
+
+    std::cout << "\nstd::map Benchmark (" << bench_size << " keys):\n";
+    std::vector<int> int_keys(bench_size);
+    for (int &num : int_keys) {
+        num = std::rand();
+    }
+    // Keys with long shared prefixes, like URLs
+    std::vector<std::string> string_keys(bench_size);
+    for (std::string &key : string_keys) {
+        key = "https://example.com/users/" + std::to_string(std::rand()) + "/profile";
+    }
+
+    auto seconds_since = [](std::chrono::high_resolution_clock::time_point start) {
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count();
+    };
+
+    {
+        RBTree<int, int> tree;
+        std::map<int, int> map;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        for (int num : int_keys) tree.try_emplace(num, num);
+        double tree_insert = seconds_since(start_time);
+        start_time = std::chrono::high_resolution_clock::now();
+        for (int num : int_keys) map.try_emplace(num, num);
+        double map_insert = seconds_since(start_time);
+
+        long long found = 0;
+        start_time = std::chrono::high_resolution_clock::now();
+        for (int num : int_keys) found += tree.search(num);
+        double tree_search = seconds_since(start_time);
+        start_time = std::chrono::high_resolution_clock::now();
+        for (int num : int_keys) found -= map.count(num);
+        double map_search = seconds_since(start_time);
+        assert(found == 0);
+
+        std::cout << "int keys:    RBTree insert " << tree_insert << "s search " << tree_search
+                  << "s | std::map insert " << map_insert << "s search " << map_search << "s\n";
+    }
+
+    {
+        RBTree<std::string, int, std::less<>> tree;
+        std::map<std::string, int, std::less<>> map;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        for (const std::string &key : string_keys) tree.try_emplace(key, 0);
+        double tree_insert = seconds_since(start_time);
+        start_time = std::chrono::high_resolution_clock::now();
+        for (const std::string &key : string_keys) map.try_emplace(key, 0);
+        double map_insert = seconds_since(start_time);
+
+        // Lookups go through std::string_view, neither container allocates
+        long long found = 0;
+        start_time = std::chrono::high_resolution_clock::now();
+        for (const std::string &key : string_keys) found += tree.search(std::string_view(key));
+        double tree_search = seconds_since(start_time);
+        start_time = std::chrono::high_resolution_clock::now();
+        for (const std::string &key : string_keys) found -= map.count(std::string_view(key));
+        double map_search = seconds_since(start_time);
+        assert(found == 0);
+
+        std::cout << "string keys: RBTree insert " << tree_insert << "s search " << tree_search
+                  << "s | std::map insert " << map_insert << "s search " << map_search << "s\n";
+    }
+}
+
+// Compare the set operations against inserting or removing one key at a time
+void benchmark_rb_tree_set_operations() {
+    const int large_size = 1000000;
+    const int sizes[] = {1000, 1000000};
+    int num_threads = static_cast<int>(std::thread::hardware_concurrency());
+
+    std::cout << "\nSet Operation Benchmark (" << large_size << " keys, " << num_threads << " hardware threads):\n";
+    auto seconds_since = [](std::chrono::high_resolution_clock::time_point start) {
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count();
+    };
+    std::vector<int> large_keys(large_size);
+    for (int &num : large_keys) num = std::rand();
+
+    for (int small_size : sizes) {
+        std::vector<int> small_keys(small_size);
+        for (int &num : small_keys) num = std::rand();
+
+        auto build = [](const std::vector<int> &keys) {
+            RBTree<int, int> tree;
+            for (int num : keys) tree.insert(num, num);
+            return tree;
+        };
+
+        RBTree<int, int> by_insert = build(large_keys);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        for (int num : small_keys) by_insert.insert(num, num);
+        double insert_time = seconds_since(start_time);
+
+        double union_times[2];
+        for (int parallel = 0; parallel < 2; parallel++) {
+            RBTree<int, int> tree = build(large_keys);
+            RBTree<int, int> other = build(small_keys);
+            start_time = std::chrono::high_resolution_clock::now();
+            tree.set_union(std::move(other), parallel ? num_threads : 1);
+            union_times[parallel] = seconds_since(start_time);
+            assert(tree.size() == by_insert.size());
+        }
+
+        RBTree<int, int> by_remove = build(large_keys);
+        start_time = std::chrono::high_resolution_clock::now();
+        for (int num : small_keys) by_remove.remove(num);
+        double remove_time = seconds_since(start_time);
+
+        RBTree<int, int> tree = build(large_keys);
+        RBTree<int, int> other = build(small_keys);
+        start_time = std::chrono::high_resolution_clock::now();
+        tree.set_difference(std::move(other), num_threads);
+        double difference_time = seconds_since(start_time);
+        assert(tree.size() == by_remove.size());
+
+        std::cout << small_size << " keys into " << large_size << ": insert loop " << insert_time << "s, set_union "
+                  << union_times[0] << "s (1 thread) " << union_times[1] << "s (" << num_threads
+                  << " threads) | remove loop " << remove_time << "s, set_difference " << difference_time << "s\n";
+    }
+}
+
+void benchmark_rb_tree_stats() {
+    const int bench_size = 1000000;
+    const int lookups_per_reader = 100000;
+    std::cout << "\nStats Benchmark (" << bench_size << " keys, " << std::thread::hardware_concurrency()
+              << " hardware threads):\n";
+    auto seconds_since = [](std::chrono::high_resolution_clock::time_point start) {
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return elapsed.count();
+    };
+    std::vector<int> keys(bench_size);
+    for (int &num : keys) num = std::rand();
+    RBTree<int, int> tree;
+    std::map<int, int> std_map;
+    for (int num : keys) {
+        tree.insert(num, num);
+        std_map.emplace(num, num);
+    }
+
+    // Every RBTree lookup records itself, std::map is the same search without counters
+    auto run_readers = [&](int num_readers, auto search) {
+        std::atomic<size_t> hits{0};
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> readers;
+        for (int t = 0; t < num_readers; t++) {
+            readers.emplace_back([&, t] {
+                size_t local_hits = 0;
+                for (int i = 0; i < lookups_per_reader; i++) {
+                    local_hits += search(keys[(static_cast<size_t>(i) * 7919 + t) % keys.size()]);
+                }
+                hits.fetch_add(local_hits);
+            });
+        }
+        for (std::thread &reader : readers) reader.join();
+        double elapsed = seconds_since(start_time);
+        assert(hits.load() == static_cast<size_t>(num_readers) * lookups_per_reader);
+        return static_cast<double>(num_readers) * lookups_per_reader / elapsed;
+    };
+    for (int num_readers : {1, 2, 4, 8}) {
+        double tree_rate = run_readers(num_readers, [&](int key) { return tree.search(key); });
+        double map_rate = run_readers(num_readers, [&](int key) { return std_map.count(key) != 0; });
+        std::cout << num_readers << " reader threads: RBTree " << tree_rate / 1e6 << "M lookups/s | std::map "
+                  << map_rate / 1e6 << "M lookups/s\n";
+    }
+
+    // A full walk against the longest of many bounded steps
+    auto start_time = std::chrono::high_resolution_clock::now();
+    RBTreeStats full = tree.stats();
+    double full_time = seconds_since(start_time);
+    RBTree<int, int>::ShapeWalk walk;
+    RBTreeStats stepped = {};
+    double max_step_time = 0.0;
+    int steps = 0;
+    bool finished = false;
+    while (!finished) {
+        start_time = std::chrono::high_resolution_clock::now();
+        finished = tree.stats_step(walk, 4096, stepped);
+        max_step_time = std::max(max_step_time, seconds_since(start_time));
+        steps++;
+    }
+    assert(stepped.depth_histogram == full.depth_histogram);
+    std::cout << "stats(): " << full_time << "s | stats_step(4096): " << steps << " steps, longest "
+              << max_step_time << "s\n";
 }
 
 int main() {
     std::srand(static_cast<unsigned int>(std::time(nullptr))); // Seed RNG
     test_rb_tree();
+    test_rb_tree_map();
+    test_rb_tree_iterators();
+    test_rb_tree_set_operations();
+    test_rb_tree_stats();
+    test_mapped_rb_tree();
+    benchmark_rb_tree_vs_std_map();
+    benchmark_rb_tree_set_operations();
+    benchmark_rb_tree_stats();
     std::cout << "All tests passed.\n";
     return 0;
 }